@@ -8,206 +8,1354 @@
 #include "BuildQueue.h"
 #include "HeadsUpDisplay.h"
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Define static variables first to prevent undefined ref errors.
+std::vector<BuildQueue::ItemConstructor> BuildQueue::_itemConstructors;
+
+/**
+ * @brief Appends the given unsigned value to the given buffer, least significant
+ * byte first, so the serialized format is the same on every platform.
+ * 
+ * @param buffer The buffer to append to.
+ * @param value The value to append.
+ */
+template <typename T>
+static void WriteValue(std::vector<unsigned char> &buffer, T value)
+{
+    static_assert(std::is_unsigned<T>::value, "Only unsigned values can be written.");
+
+    for (std::size_t i = 0; i < sizeof(T); i++)
+    {
+        buffer.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+/**
+ * @brief Appends the given float to the given buffer, as the little endian bytes
+ * of its 32 bit IEEE 754 representation.
+ * 
+ * @param buffer The buffer to append to.
+ * @param value The value to append.
+ */
+static void WriteValue(std::vector<unsigned char> &buffer, float value)
+{
+    static_assert(sizeof(float) == sizeof(std::uint32_t), "Floats must be 32 bits.");
+
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteValue(buffer, bits);
+}
+
+/**
+ * @brief Reads an unsigned value written by WriteValue from the given position
+ * and advances the position past it.
+ * 
+ * @param data The position to read from.
+ * @param end The end of the data.
+ * @param value The value to read into.
+ * @return bool Whether there were enough bytes left to read the value.
+ */
+template <typename T>
+static bool ReadValue(const unsigned char *&data, const unsigned char *end, T &value)
+{
+    static_assert(std::is_unsigned<T>::value, "Only unsigned values can be read.");
+
+    if (end - data < static_cast<std::ptrdiff_t>(sizeof(T)))
+    {
+        return false;
+    }
+
+    value = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++)
+    {
+        value |= static_cast<T>(static_cast<T>(data[i]) << (8 * i));
+    }
+    data += sizeof(T);
+    return true;
+}
+
+/**
+ * @brief Reads a float written by WriteValue from the given position and
+ * advances the position past it.
+ * 
+ * @param data The position to read from.
+ * @param end The end of the data.
+ * @param value The value to read into.
+ * @return bool Whether there were enough bytes left to read the value.
+ */
+static bool ReadValue(const unsigned char *&data, const unsigned char *end, float &value)
+{
+    std::uint32_t bits;
+    if (!ReadValue(data, end, bits))
+    {
+        return false;
+    }
+
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+/**
+ * @brief Constructs a BuildQueue that reports its changes to the HeadsUpDisplay.
+ * Maximum queue capacity and number of lanes can be specified.
+ * 
+ * @param queueCapacity The maximum capacity of the queue.
+ * @param laneCount The number of items that are in production at the same time.
+ */
+BuildQueue::BuildQueue(int queueCapacity, int laneCount)
+    : BuildQueue(queueCapacity, laneCount, HeadsUpDisplay::GetInstance())
+{
+}
+
+/**
+ * @brief Constructs a BuildQueue that reports its changes to the given
+ * HeadsUpDisplay, or to none at all if it is null.
+ * 
+ * @param queueCapacity The maximum capacity of the queue.
+ * @param laneCount The number of items that are in production at the same time.
+ * @param headsUpDisplay The HUD to show the queue in, or null to show it nowhere.
+ * @param addToGameWorld Whether the GameWorld updates the queue. Pass false for
+ * queues whose owner calls Update itself, like benchmark queues.
+ */
+BuildQueue::BuildQueue(int queueCapacity, int laneCount, HeadsUpDisplay *headsUpDisplay,
+                       bool addToGameWorld)
+    : IUpdatable(addToGameWorld),
+      _headsUpDisplay(headsUpDisplay)
+{
+    _laneCount = std::max(laneCount, 1);
+    _laneFinishTimes.resize(_laneCount);
+    _finishedItems.reserve(_laneCount);
+
+    // Allocate all item storage up front, so enqueueing never allocates.
+    AllocateSlots(queueCapacity);
+}
+
+/**
+ * @brief Delete all remaining queue items upon deletion of
+ * the BuildQueue.
+ */
+BuildQueue::~BuildQueue()
+{
+    Clear();
+}
+
+/**
+ * @brief Returns the index of the item in the queue + 1,
+ * so it starts counting up from 1 at the start of the queue.
+ * 0 if the item isn't enqueued. Takes O(log n).
+ */
+int BuildQueue::IQueueItem::GetQueueIndex()
+{
+    return _buildQueue ? _buildQueue->GetQueueIndex(_slotIndex) + 1 : 0;
+}
+
+/**
+ * @brief Registers the constructor for the item type with the given id, so
+ * serialized queues containing items of that type can be deserialized.
+ * 
+ * @param typeId The id of the item type, as returned by its GetItemTypeId.
+ * @param constructor The function that constructs an item of the type.
+ */
+void BuildQueue::RegisterItemType(unsigned short typeId, ItemConstructor constructor)
+{
+    // Make sure the id doesn't mark items as not serializable.
+    if (typeId == NO_ITEM_TYPE_ID)
+    {
+        printf("Tried to register a BuildQueue item type under the reserved id %d.\n", typeId);
+        return;
+    }
+
+    if (typeId >= _itemConstructors.size())
+    {
+        _itemConstructors.resize(typeId + 1, nullptr);
+    }
+
+    _itemConstructors[typeId] = constructor;
+}
+
+/**
+ * @brief Finishes enqueueing an item that was just constructed in the last free slot.
+ * Destroys the item again if its OnBuildQueueStart function evaluates to false.
+ * 
+ * @param item The item that was constructed in the slot.
+ * @param finishFunction The function to call when the item finishes the queue.
+ * @return ItemHandle A handle to the enqueued item, empty if the enqueue failed.
+ */
+BuildQueue::ItemHandle BuildQueue::FinishEnqueue(IQueueItem *item, InplaceCallback &finishFunction)
+{
+    // Make sure the requirements for the enqueue are met.
+    if (!item->OnBuildQueueStart())
+    {
+        // Requirements not met, so destroy the item again. The slot was never
+        // taken from the free slots, so there is no need to return it.
+        item->~IQueueItem();
+
+        // Return an empty handle, since the item was not enqueued.
+        return ItemHandle();
+    }
+
+    // Claim the slot the item was constructed in and push it to the queue.
+    ItemHandle handle = PushItem(item, std::move(finishFunction));
+    RecordEnqueued(1);
+
+    // Refresh queue UI.
+    RefreshQueueOrder();
+
+    // Return the handle, since the item was successfully enqueued.
+    return handle;
+}
+
+/**
+ * @brief Claims the last free slot for the given item, which must have been
+ * constructed in it, and pushes the item to the back of the queue.
+ * 
+ * @param item The item to push.
+ * @param finishFunction The function to call when the item finishes the queue.
+ * @return ItemHandle A handle to the pushed item.
+ */
+BuildQueue::ItemHandle BuildQueue::PushItem(IQueueItem *item, InplaceCallback finishFunction)
+{
+    // Claim the slot the item was constructed in.
+    int slotIndex = _freeSlots.back();
+    _freeSlots.pop_back();
+
+    // Initialize item and its slot before linking it in at the back of the queue.
+    item->_slotIndex = slotIndex;
+    item->_buildQueue = this;
+    item->Initialize(finishFunction);
+
+    SlotState &slot = _slotStates[slotIndex];
+    slot.item = item;
+    slot.duration = item->GetQueueTime();
+    slot.timer = 0;
+    LinkAtBack(slotIndex);
+
+    // Return a handle to the item in its slot.
+    ItemHandle handle;
+    handle.slotIndex = slotIndex;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+/**
+ * @brief Refreshes the queue UI after the order of the queue changed.
+ */
+void BuildQueue::RefreshQueueOrder()
+{
+    if (_headsUpDisplay)
+    {
+        _headsUpDisplay->UpdateBuildQueueOrder(this);
+    }
+}
+
+/**
+ * @brief Records the given number of enqueued items, in both the counters
+ * of this queue and the global counters.
+ * 
+ * @param itemCount The number of items that were enqueued.
+ */
+void BuildQueue::RecordEnqueued(int itemCount)
+{
+    _statistics.itemsEnqueued += itemCount;
+    if (_reportsTelemetry)
+    {
+        BuildQueueTelemetry::RecordEnqueued(itemCount);
+    }
+}
+
+/**
+ * @brief Records the given number of cancelled items, in both the counters
+ * of this queue and the global counters.
+ * 
+ * @param itemCount The number of items that were cancelled.
+ */
+void BuildQueue::RecordCancelled(int itemCount)
+{
+    _statistics.itemsCancelled += itemCount;
+    if (_reportsTelemetry)
+    {
+        BuildQueueTelemetry::RecordCancelled(itemCount);
+    }
+}
+
+/**
+ * @brief Refreshes the queue UI after the progress of the queue changed.
+ */
+void BuildQueue::RefreshQueueProgress()
+{
+    if (_headsUpDisplay)
+    {
+        _headsUpDisplay->UpdateBuildQueueProgressBar(this);
+    }
+}
+
+/**
+ * @brief Submits a command to enqueue a batch of items of a registered type.
+ * The items are constructed with the registered constructor and validated
+ * with OnBuildQueueStartBatch at the start of the next Update.
+ * Safe to call from any thread.
+ * 
+ * @param typeId The id the item type was registered under.
+ * @param count The number of items to enqueue.
+ * @param context Passed to the registered item constructor.
+ * @param result Optional result to fill in once the command is applied.
+ * @return bool Whether the command was submitted. False if too many commands
+ * are already waiting to be applied.
+ */
+bool BuildQueue::SubmitEnqueue(unsigned short typeId, int count, void *context,
+                               CommandResult *result)
+{
+    Command command;
+    command.type = Command::eEnqueue;
+    command.typeId = typeId;
+    command.count = count;
+    command.context = context;
+    command.result = result;
+
+    // Reset the result before the command becomes visible to the main thread.
+    if (result)
+    {
+        result->applied.store(false, std::memory_order_relaxed);
+    }
+
+    if (!_commands.TryPush(command))
+    {
+        return false;
+    }
+
+    if (_reportsTelemetry)
+    {
+        BuildQueueTelemetry::RecordCommandSubmitted();
+    }
+    return true;
+}
+
+/**
+ * @brief Submits a command to cancel the item the given handle refers to.
+ * The item is cancelled at the start of the next Update, if it is still enqueued.
+ * Safe to call from any thread.
+ * 
+ * @param handle The handle of the item to cancel.
+ * @param result Optional result to fill in once the command is applied.
+ * @return bool Whether the command was submitted. False if too many commands
+ * are already waiting to be applied.
+ */
+bool BuildQueue::SubmitCancel(ItemHandle handle, CommandResult *result)
+{
+    Command command;
+    command.type = Command::eCancel;
+    command.handle = handle;
+    command.result = result;
+
+    // Reset the result before the command becomes visible to the main thread.
+    if (result)
+    {
+        result->applied.store(false, std::memory_order_relaxed);
+    }
+
+    if (!_commands.TryPush(command))
+    {
+        return false;
+    }
+
+    if (_reportsTelemetry)
+    {
+        BuildQueueTelemetry::RecordCommandSubmitted();
+    }
+    return true;
+}
+
+/**
+ * @brief Applies all submitted commands, in the order they were submitted.
+ * Refreshes the queue UI once if any of them changed the queue.
+ */
+void BuildQueue::ApplyCommands()
+{
+    bool queueChanged = false;
+    Command command;
+
+    while (_commands.TryPop(command))
+    {
+        // Count the command for this queue here, since the submitting thread
+        // can't touch the queue's own counters.
+        _statistics.commandsSubmitted++;
+
+        int itemCount = 0;
+        ItemHandle handle;
+
+        // Handle all command types.
+        switch (command.type)
+        {
+            case Command::eEnqueue:
+            {
+                itemCount = EnqueueRegistered(command.typeId, command.count,
+                                              command.context, handle);
+                if (itemCount > 0)
+                {
+                    RecordEnqueued(itemCount);
+                }
+                break;
+            }
+            case Command::eCancel:
+            {
+                int slotIndex = GetSlot(command.handle);
+                if (slotIndex >= 0)
+                {
+                    // Call cancel function on the item before removing it from the queue.
+                    _slotStates[slotIndex].item->OnBuildQueueCancel();
+                    DestroyItem(slotIndex);
+                    RecordCancelled(1);
+                    itemCount = 1;
+                }
+                break;
+            }
+        }
+
+        queueChanged = queueChanged || itemCount > 0;
+
+        // Report the outcome back to the submitter.
+        if (command.result)
+        {
+            command.result->itemCount = itemCount;
+            command.result->handle = handle;
+            command.result->applied.store(true, std::memory_order_release);
+        }
+    }
+
+    // Refresh queue UI once for all applied commands.
+    if (queueChanged)
+    {
+        RefreshQueueOrder();
+    }
+}
+
+/**
+ * @brief Enqueues a batch of items of a registered type, constructed with the
+ * registered constructor and validated with OnBuildQueueStartBatch.
+ * Doesn't refresh the queue UI.
+ * 
+ * @param typeId The id the item type was registered under.
+ * @param count The number of items to enqueue.
+ * @param context Passed to the registered item constructor.
+ * @param firstHandle Set to a handle to the first enqueued item.
+ * @return int The number of items that were successfully enqueued.
+ */
+int BuildQueue::EnqueueRegistered(unsigned short typeId, int count, void *context,
+                                  ItemHandle &firstHandle)
+{
+    // Make sure the item type was registered.
+    if (typeId >= _itemConstructors.size() || !_itemConstructors[typeId])
+    {
+        printf("Tried to enqueue a BuildQueue item of unregistered type %d.\n", typeId);
+        return 0;
+    }
+
+    // Construct every item with the registered constructor.
+    ItemConstructor constructor = _itemConstructors[typeId];
+    auto constructItem = [&](void *storage, InplaceCallback &finishFunction)
+    {
+        return constructor(storage, context, finishFunction);
+    };
+
+    return StartBatch(count, constructItem, firstHandle);
+}
+
+/**
+ * @brief Cancels the specified item in the build queue.
+ * Only pass items that are enqueued right now, like the ones in GetQueueList.
+ * Items live in reused slots, so a pointer to an item that left the queue may
+ * point at a newer item in the same slot. Keep an ItemHandle to refer to an
+ * item for longer instead.
+ * 
+ * @param item The item to cancel.
+ * @return bool Whether the item was present and subsequently removed from the build queue.
+ */
+bool BuildQueue::Cancel(IQueueItem *item)
+{
+    return Cancel(GetHandle(item));
+}
+
+/**
+ * @brief Cancels the item the given handle refers to.
+ * 
+ * @param handle The handle of the item to cancel.
+ * @return bool Whether the item was present and subsequently removed from the build queue.
+ */
+bool BuildQueue::Cancel(ItemHandle handle)
+{
+    int slotIndex = GetSlot(handle);
+
+    // Make sure the item is present in the build queue.
+    if (slotIndex < 0)
+    {
+        // The specified item was not present in the build queue,
+        // so return false.
+        return false;
+    }
+
+    // Call cancel function on the item before removing it from the queue.
+    _slotStates[slotIndex].item->OnBuildQueueCancel();
+
+    // Destroy the item and remove it from the build queue.
+    DestroyItem(slotIndex);
+    RecordCancelled(1);
+
+    // Refresh queue UI.
+    RefreshQueueOrder();
+
+    // Return true, since the item was found in the build queue.
+    return true;
+}
+
+/**
+ * @brief Moves the item the given handle refers to to the front of the queue,
+ * making it the current item. Progress on the previous current item is kept.
+ * 
+ * @param handle The handle of the item to move.
+ * @return bool Whether the item was present in the build queue.
+ */
+bool BuildQueue::MoveToFront(ItemHandle handle)
+{
+    int slotIndex = GetSlot(handle);
+
+    // Make sure the item is present in the build queue.
+    if (slotIndex < 0)
+    {
+        return false;
+    }
+
+    // Relink the item at the front, unless it's already there.
+    if (slotIndex != _frontSlot)
+    {
+        Unlink(slotIndex);
+        LinkAtFront(slotIndex);
+        RefreshQueueOrder();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Moves the item the given handle refers to to the back of the queue.
+ * Progress on the item is kept.
+ * 
+ * @param handle The handle of the item to move.
+ * @return bool Whether the item was present in the build queue.
+ */
+bool BuildQueue::MoveToBack(ItemHandle handle)
+{
+    int slotIndex = GetSlot(handle);
+
+    // Make sure the item is present in the build queue.
+    if (slotIndex < 0)
+    {
+        return false;
+    }
+
+    // Relink the item at the back, unless it's already there.
+    if (slotIndex != _backSlot)
+    {
+        Unlink(slotIndex);
+        LinkAtBack(slotIndex);
+        RefreshQueueOrder();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns a handle to the given item, or an empty handle if the item
+ * isn't enqueued in this build queue. Like Cancel, only pass items that are
+ * enqueued right now. The handle stays safe to use after that.
+ * 
+ * @param item The item to get a handle for.
+ * @return ItemHandle A handle to the item.
+ */
+BuildQueue::ItemHandle BuildQueue::GetHandle(IQueueItem *item)
+{
+    ItemHandle handle;
+
+    // Only items that live in one of our slots have a handle. Items that were
+    // never enqueued have no queue, and destroyed items no longer own their slot.
+    if (item && item->_buildQueue == this &&
+        item->_slotIndex >= 0 && item->_slotIndex < _queueCapacity &&
+        _slotStates[item->_slotIndex].item == item)
+    {
+        handle.slotIndex = item->_slotIndex;
+        handle.generation = _slotStates[item->_slotIndex].generation;
+    }
+
+    return handle;
+}
+
+/**
+ * @brief Returns the item the given handle refers to, or null if that item
+ * is no longer enqueued in this build queue.
+ * 
+ * @param handle The handle of the item to get.
+ * @return IQueueItem* The item the handle refers to.
+ */
+BuildQueue::IQueueItem *BuildQueue::GetItem(ItemHandle handle)
+{
+    int slotIndex = GetSlot(handle);
+    return slotIndex < 0 ? nullptr : _slotStates[slotIndex].item;
+}
+
+/**
+ * @brief Returns the progress of the current item in the queue.
+ * 
+ * @return float A number between 0 and 1 indicating the progress of the
+ * current item in the queue.
+ */
+float BuildQueue::GetCurrentItemProgress()
+{
+    return GetLaneProgress(0);
+}
+
+/**
+ * @brief Returns the progress of the item in the given lane.
+ * Lane 0 holds the current item, lane 1 the item behind it, and so on.
+ * 
+ * @param lane The lane to get the progress for.
+ * @return float A number between 0 and 1 indicating the progress of the
+ * item in the lane. 1 if there is no item in the lane.
+ */
+float BuildQueue::GetLaneProgress(int lane)
+{
+    // Return 1 if there is no such lane.
+    if (lane < 0 || lane >= _laneCount)
+    {
+        return 1;
+    }
+
+    // Walk up to the item in the lane, which is one of the first few.
+    int slotIndex = _frontSlot;
+    for (int i = 0; i < lane && slotIndex >= 0; i++)
+    {
+        slotIndex = _slotStates[slotIndex].nextSlot;
+    }
+
+    // Return 1 if there is no item in the lane.
+    if (slotIndex < 0)
+    {
+        return 1;
+    }
+
+    // Return progress of the item in the lane.
+    SlotState &slot = _slotStates[slotIndex];
+    return irr::core::clamp(slot.timer / slot.duration, 0.f, 1.f);
+}
+
+/**
+ * @brief Returns the number of items that are in production at the same time.
+ * 
+ * @return int The number of lanes of the queue.
+ */
+int BuildQueue::GetLaneCount()
+{
+    return _laneCount;
+}
+
 /**
- * @brief Constructs a BuildQueue.
- * Maximum queue capacity can be specified.
+ * @brief Returns the production counters of this queue since it was created.
+ * Use BuildQueueTelemetry::GetGlobalStatistics for the counters of all queues.
  * 
- * @param queueCapacity The maximum capacity of the queue.
+ * @return const BuildQueueStatistics& The counters of this queue.
  */
-BuildQueue::BuildQueue(int queueCapacity)
+const BuildQueueStatistics &BuildQueue::GetStatistics()
 {
-    _queueCapacity = queueCapacity;
+    return _statistics;
 }
 
 /**
- * @brief Delete all remaining queue items upon deletion of
- * the BuildQueue.
+ * @brief Sets whether the queue adds its counters to the global counters of
+ * BuildQueueTelemetry, which it does by default. Turn this off for queues that
+ * aren't part of the game, like benchmark queues. Its own counters are kept
+ * either way. Set it before other threads submit commands to the queue.
+ * 
+ * @param reportsTelemetry Whether to add to the global counters.
  */
-BuildQueue::~BuildQueue()
+void BuildQueue::SetReportsTelemetry(bool reportsTelemetry)
+{
+    _reportsTelemetry = reportsTelemetry;
+}
+
+/**
+ * @brief Returns the time in seconds until the item at the given index in the
+ * queue finishes, including the time needed for all items in front of it.
+ * Takes O(log n) with a single lane. With several lanes the items in front
+ * are scheduled one by one, so it takes time linear in the index.
+ * 
+ * @param queueIndex The index of the item in the queue, 0 being the current item.
+ * @return float The remaining time in seconds until the item finishes.
+ * 0 if there is no item at the index.
+ */
+float BuildQueue::GetItemTimeRemaining(int queueIndex)
 {
-    // Loop over all remaining items in the queue.
-    for (IQueueItem * item : _queue)
+    int slotIndex = GetSlotAt(queueIndex);
+
+    // Return 0 if there is no item at the index.
+    if (slotIndex < 0)
+    {
+        return 0;
+    }
+
+    // With a single lane, the item finishes after everything in front of it.
+    if (_laneCount == 1)
     {
-        delete item;
+        double timeRemaining = _orderTimes.GetSum(_slotStates[slotIndex].orderKey + 1);
+        return std::max(static_cast<float>(timeRemaining), 0.f);
     }
+
+    // Otherwise, the items in front of it decide which lane it gets and when.
+    float timeRemaining = 0;
+    auto visit = [&](float finishTime)
+    {
+        timeRemaining = finishTime;
+    };
+    ScheduleLanes(queueIndex + 1, visit);
+
+    return timeRemaining;
 }
 
 /**
- * @brief Attempt to enqueue the given item. If the item's OnBuildQueueStart
- * function evaluates to false, or the queue is full, this function will end
- * and return false. Returns true upon a successful enqueue.
+ * @brief Returns the time in seconds until all items in the queue are finished.
+ * Takes O(log n) with a single lane, and walks the queue with several lanes.
  * 
- * @param item The item to enqueue.
- * @param finishFunction The function to call when the item finishes the queue.
- * @return bool Whether the item was successfully enqueued or not.
+ * @return float The remaining time in seconds until the queue is empty.
+ */
+float BuildQueue::GetTotalTimeRemaining()
+{
+    // With a single lane, the last item finishes last.
+    if (_laneCount == 1)
+    {
+        return std::max(static_cast<float>(_orderTimes.GetTotal()), 0.f);
+    }
+
+    float timeRemaining = 0;
+    auto visit = [&](float finishTime)
+    {
+        timeRemaining = std::max(timeRemaining, finishTime);
+    };
+    ScheduleLanes(_queueCapacity, visit);
+
+    return timeRemaining;
+}
+
+/**
+ * @brief Fills the given list with the remaining time in seconds until each item
+ * in the queue finishes, in queue order.
+ * 
+ * @param timesRemaining The list to fill. Existing contents are replaced.
+ */
+void BuildQueue::GetTimesRemaining(std::vector<float> &timesRemaining)
+{
+    timesRemaining.clear();
+
+    auto visit = [&](float finishTime)
+    {
+        timesRemaining.push_back(finishTime);
+    };
+    ScheduleLanes(_queueCapacity, visit);
+}
+
+/**
+ * @brief Returns a const pointer to the internal vector of enqueued items.
+ * The vector is only brought up to date by this call, walking the queue if it
+ * changed since the last call, so fetch it again after changing the queue.
+ * 
+ * @return const std::vector<IQueueItem *>* const A const pointer to the build queue.
+ */
+const std::vector<BuildQueue::IQueueItem *>* const BuildQueue::GetQueueList()
+{
+    // Walk the slot links again, only if the order changed since the last call.
+    if (_queueListChanged)
+    {
+        _queue.clear();
+        for (int slotIndex = _frontSlot; slotIndex >= 0; slotIndex = _slotStates[slotIndex].nextSlot)
+        {
+            _queue.push_back(_slotStates[slotIndex].item);
+        }
+
+        _queueListChanged = false;
+    }
+
+    return &_queue;
+}
+
+/**
+ * @brief Returns the exact number of bytes Serialize will append for this
+ * queue's current state. Sum this over all queues to reserve a save buffer once.
+ * 
+ * @return std::size_t The serialized size of the queue in bytes.
+ */
+std::size_t BuildQueue::GetSerializedSize()
+{
+    // Version, capacity, lane count and item count, then a type id and timer per item.
+    std::size_t itemCount = _queueCapacity - _freeSlots.size();
+    return 4 * sizeof(unsigned short) + itemCount * (sizeof(unsigned short) + sizeof(float));
+}
+
+/**
+ * @brief Appends the state of the queue to the given buffer, in a compact,
+ * versioned, little endian binary format: the capacity and lane count, then the
+ * type id and timer of each item in queue order. Finish functions are not
+ * serialized; they are restored by the registered item constructors.
+ * 
+ * @param buffer The buffer to append the queue state to.
+ * @return bool Whether the queue could be serialized. False if the capacity or
+ * lane count doesn't fit the format, or an item has no type id, in which case
+ * the buffer is left unchanged.
  */
-bool BuildQueue::Enqueue(IQueueItem *item, std::function<void()> finishFunction)
+bool BuildQueue::Serialize(std::vector<unsigned char> &buffer)
 {
-    // Make sure there is still space left in the build queue.
-    if (_queue.size() + 1 > _queueCapacity)
+    const int maximumValue = std::numeric_limits<unsigned short>::max();
+
+    // Make sure the header fits the format. The item count never exceeds the capacity.
+    if (_queueCapacity > maximumValue || _laneCount > maximumValue)
     {
-        // Build queue capacity reached, so return false.
+        printf("Tried to serialize a BuildQueue with a capacity or lane count above %d.\n",
+               maximumValue);
         return false;
     }
 
-    // Make sure the requirements for the enqueue are met.
-    if (!item->OnBuildQueueStart())
+    // Make sure the buffer only grows once.
+    std::size_t startSize = buffer.size();
+    buffer.reserve(startSize + GetSerializedSize());
+
+    // Write the header.
+    WriteValue<unsigned short>(buffer, SERIALIZATION_VERSION);
+    WriteValue<unsigned short>(buffer, _queueCapacity);
+    WriteValue<unsigned short>(buffer, _laneCount);
+    WriteValue<unsigned short>(buffer, _queueCapacity - _freeSlots.size());
+
+    // Write all items in queue order.
+    for (int slotIndex = _frontSlot; slotIndex >= 0; slotIndex = _slotStates[slotIndex].nextSlot)
+    {
+        SlotState &slot = _slotStates[slotIndex];
+        unsigned short typeId = slot.item->GetItemTypeId();
+
+        // Items that don't report a type id can't be restored, so give up.
+        if (typeId == NO_ITEM_TYPE_ID)
+        {
+            printf("Tried to serialize a BuildQueue item without a type id.\n");
+            buffer.resize(startSize);
+            return false;
+        }
+
+        WriteValue<unsigned short>(buffer, typeId);
+        WriteValue(buffer, slot.timer);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Replaces the state of the queue with the state serialized at the given
+ * position, and advances the position past it. Existing items are removed
+ * without calling their cancel functions, and restored items are not asked
+ * to perform their OnBuildQueueStart checks.
+ * 
+ * @param data The position to read from. Advanced past the queue state on success.
+ * @param end The end of the serialized data.
+ * @param context Passed to the registered item constructors, like the queue's owner.
+ * @return bool Whether the queue state was read successfully. The queue is left
+ * empty if it wasn't.
+ */
+bool BuildQueue::Deserialize(const unsigned char *&data, const unsigned char *end, void *context)
+{
+    // Start from an empty queue.
+    Clear();
+
+    // Leave the queue empty again if its state couldn't be read completely.
+    bool stateRead = ReadState(data, end, context);
+    if (!stateRead)
+    {
+        Clear();
+    }
+
+    // Refresh queue UI either way, since the old items are gone.
+    RefreshQueueOrder();
+
+    return stateRead;
+}
+
+/**
+ * @brief Reads the state serialized at the given position into the empty queue,
+ * and advances the position past it. Doesn't refresh the queue UI, and may leave
+ * some restored items behind if it fails.
+ * 
+ * @param data The position to read from. Advanced past the queue state on success.
+ * @param end The end of the serialized data.
+ * @param context Passed to the registered item constructors.
+ * @return bool Whether the queue state was read successfully.
+ */
+bool BuildQueue::ReadState(const unsigned char *&data, const unsigned char *end, void *context)
+{
+    const unsigned char *position = data;
+    unsigned short version, capacity, itemCount;
+    unsigned short laneCount = _laneCount;
+
+    // Read and validate the header. Version 1 has no lane count, so the queue's
+    // own lane count is kept for it.
+    if (!ReadValue(position, end, version) ||
+        !ReadValue(position, end, capacity) ||
+        (version >= 2 && !ReadValue(position, end, laneCount)) ||
+        !ReadValue(position, end, itemCount))
+    {
+        printf("Tried to deserialize a BuildQueue from truncated data.\n");
+        return false;
+    }
+
+    if (version < 1 || version > SERIALIZATION_VERSION || itemCount > capacity || laneCount < 1)
     {
-        // Requirements not met, so return false.
+        printf("Tried to deserialize a BuildQueue with an unsupported format.\n");
         return false;
     }
 
-    // Initialize item before pushing it to the queue.
-    item->Initialize(_queue.size(), finishFunction);
-    _queue.push_back(item);
+    _laneCount = laneCount;
+    _laneFinishTimes.resize(_laneCount);
+    _finishedItems.reserve(_laneCount);
 
-    // Refresh queue UI.
-    HeadsUpDisplay::GetInstance()->UpdateBuildQueueOrder(this);
+    // The queue is empty, so the storage can safely be reallocated.
+    if (capacity != _queueCapacity)
+    {
+        AllocateSlots(capacity);
+    }
+
+    // Restore all items in queue order.
+    for (int i = 0; i < itemCount; i++)
+    {
+        unsigned short typeId;
+        float timer;
+        if (!ReadValue(position, end, typeId) || !ReadValue(position, end, timer))
+        {
+            printf("Tried to deserialize a BuildQueue from truncated data.\n");
+            return false;
+        }
+
+        if (typeId >= _itemConstructors.size() || !_itemConstructors[typeId])
+        {
+            printf("Tried to deserialize a BuildQueue item of unregistered type %d.\n", typeId);
+            return false;
+        }
+
+        // Construct the item in the next free slot and push it without any checks.
+        InplaceCallback finishFunction;
+        IQueueItem *item = _itemConstructors[typeId](&_itemSlots[_freeSlots.back()],
+                                                     context,
+                                                     finishFunction);
+        ItemHandle handle = PushItem(item, std::move(finishFunction));
+        _slotStates[handle.slotIndex].timer = timer;
+        RefreshTimeLeft(handle.slotIndex);
+    }
 
-    // Return true, since the item was successfully enqueued.
+    data = position;
     return true;
 }
 
 /**
- * @brief Cancels the specified item in the build queue.
+ * @brief: Updates the queue timer and handles dequeueing at the right time.
+ */
+void BuildQueue::Update()
+{
+    // Apply commands submitted from other threads first, so they always take
+    // effect at the same point in the frame.
+    ApplyCommands();
+
+    float deltaTime = GameTime::GetDeltaTime();
+    int queueDepth = _queueCapacity - static_cast<int>(_freeSlots.size());
+
+    // Count the frame as busy or idle time, weighted by the queue depth.
+    if (_reportsTelemetry)
+    {
+        BuildQueueTelemetry::RecordUpdate(deltaTime, queueDepth);
+    }
+
+    // If the queue is empty, count the frame as idle and return.
+    if (queueDepth == 0)
+    {
+        _statistics.idleTime += deltaTime;
+        return;
+    }
+
+    _statistics.busyTime += deltaTime;
+    _statistics.queueDepthTime += static_cast<double>(deltaTime) * queueDepth;
+    bool itemFinished = false;
+
+    // Increment the timers of the items in all lanes, and remember which items
+    // finished. Their finish functions only run after this pass, since they may
+    // cancel or enqueue items, and the rescheduling when an item finishes must
+    // see this frame's progress on every lane.
+    _finishedItems.clear();
+    int slotIndex = _frontSlot;
+    for (int lane = 0; lane < _laneCount && slotIndex >= 0; lane++)
+    {
+        SlotState &slot = _slotStates[slotIndex];
+        slot.timer += deltaTime;
+        RefreshTimeLeft(slotIndex);
+
+        // Check if the timer for the item has finished.
+        if (slot.timer >= slot.duration)
+        {
+            ItemHandle handle;
+            handle.slotIndex = slotIndex;
+            handle.generation = slot.generation;
+            _finishedItems.push_back(handle);
+        }
+
+        slotIndex = slot.nextSlot;
+    }
+
+    // Finish the items, skipping any that an earlier finish function cancelled.
+    for (int i = 0; i < _finishedItems.size(); i++)
+    {
+        int finishedSlotIndex = GetSlot(_finishedItems[i]);
+        if (finishedSlotIndex >= 0)
+        {
+            FinishItem(finishedSlotIndex);
+            itemFinished = true;
+        }
+    }
+
+    // Update queue progress bar.
+    RefreshQueueProgress();
+
+    // Refresh queue UI once for all items that finished this frame.
+    if (itemFinished)
+    {
+        RefreshQueueOrder();
+    }
+}
+
+/**
+ * @brief Calls the finish function on the item in the given slot, then removes
+ * it from the build queue, so the next waiting item can take its lane.
  * 
- * @param item The item to cancel.
- * @return bool Whether the item was present and subsequently removed from the build queue.
+ * @param slotIndex The slot of the item that finished.
  */
-bool BuildQueue::Cancel(IQueueItem *item)
+void BuildQueue::FinishItem(int slotIndex)
+{
+    // Call finish function on the item before removing it from the queue.
+    _slotStates[slotIndex].item->OnBuildQueueFinish();
+
+    // Destroy the item and remove it from the build queue.
+    DestroyItem(slotIndex);
+
+    _statistics.itemsFinished++;
+    if (_reportsTelemetry)
+    {
+        BuildQueueTelemetry::RecordFinished();
+    }
+}
+
+/**
+ * @brief Unlinks the item in the given slot from the queue, destroys it and
+ * frees the slot.
+ * 
+ * @param slotIndex The slot of the item to destroy.
+ */
+void BuildQueue::DestroyItem(int slotIndex)
 {
-    // Search for the specified item in the build queue.
-    auto i = std::find(_queue.begin(), _queue.end(), item);
+    SlotState &slot = _slotStates[slotIndex];
 
-    // Check if we found the specified item in the build queue.
-    if (i != _queue.end())
+    Unlink(slotIndex);
+
+    // Items live in the queue's own storage, so only call the destructor. Detach
+    // the item from the queue first, so a pointer to it isn't taken for enqueued.
+    slot.item->_buildQueue = nullptr;
+    slot.item->~IQueueItem();
+    slot.item = nullptr;
+
+    // Invalidate all handles to the item before freeing the slot.
+    slot.generation++;
+    _freeSlots.push_back(slotIndex);
+}
+
+/**
+ * @brief Links the given slot in at the front of the queue, with an order
+ * key below the current front item.
+ * 
+ * @param slotIndex The slot to link.
+ */
+void BuildQueue::LinkAtFront(int slotIndex)
+{
+    // Take the key below the front item, or the middle one if the queue is empty.
+    int orderKey = static_cast<int>(_keySlots.size()) / 2;
+    if (_frontSlot >= 0)
     {
-        // Check if the current item was cancelled.
-        if (i == _queue.begin())
+        // Make room below the front item first, if there is none left.
+        if (_slotStates[_frontSlot].orderKey == 0)
         {
-            // Reset timer, since the current item was cancelled,
-            // and we don't want the progress on it to roll over to the next item.
-            _currentItemTimer = 0;
+            RenumberOrder();
         }
 
-        // Call cancel function on the item before erasing it from the queue.
-        (*i)->OnBuildQueueCancel();
+        orderKey = _slotStates[_frontSlot].orderKey - 1;
+    }
+
+    SlotState &slot = _slotStates[slotIndex];
+    slot.previousSlot = -1;
+    slot.nextSlot = _frontSlot;
+
+    if (_frontSlot >= 0)
+    {
+        _slotStates[_frontSlot].previousSlot = slotIndex;
+    }
+    else
+    {
+        _backSlot = slotIndex;
+    }
 
-        // Decrement indices on all items after the erased item.
-        DecrementIndices((*i)->_queueIndex);
+    _frontSlot = slotIndex;
+    InsertIntoOrder(slotIndex, orderKey);
+}
 
-        // Delete the item.
-        delete (*i);
+/**
+ * @brief Links the given slot in at the back of the queue, with an order
+ * key above the current back item.
+ * 
+ * @param slotIndex The slot to link.
+ */
+void BuildQueue::LinkAtBack(int slotIndex)
+{
+    // Take the key above the back item, or the middle one if the queue is empty.
+    int orderKey = static_cast<int>(_keySlots.size()) / 2;
+    if (_backSlot >= 0)
+    {
+        // Make room above the back item first, if there is none left.
+        if (_slotStates[_backSlot].orderKey == static_cast<int>(_keySlots.size()) - 1)
+        {
+            RenumberOrder();
+        }
 
-        // Erase the item from the build queue.
-        _queue.erase(i);
+        orderKey = _slotStates[_backSlot].orderKey + 1;
+    }
 
-        // Refresh queue UI.
-        HeadsUpDisplay::GetInstance()->UpdateBuildQueueOrder(this);
+    SlotState &slot = _slotStates[slotIndex];
+    slot.previousSlot = _backSlot;
+    slot.nextSlot = -1;
 
-        // Return true, since the item was found in the build queue.
-        return true;
+    if (_backSlot >= 0)
+    {
+        _slotStates[_backSlot].nextSlot = slotIndex;
     }
     else
     {
-        // The specified item was not present in the build queue,
-        // so return false.
-        return false;
+        _frontSlot = slotIndex;
     }
+
+    _backSlot = slotIndex;
+    InsertIntoOrder(slotIndex, orderKey);
 }
 
 /**
- * @brief Returns the progress of the current item in the queue.
+ * @brief Unlinks the given slot from its neighbours in the queue, and
+ * removes it from the order trees.
  * 
- * @return float A number between 0 and 1 indicating the progress of the
- * current item in the queue.
+ * @param slotIndex The slot to unlink.
  */
-float BuildQueue::GetCurrentItemProgress()
+void BuildQueue::Unlink(int slotIndex)
 {
-    // Return 1 if there are no items present in the queue.
-    if (_queue.size() == 0)
+    SlotState &slot = _slotStates[slotIndex];
+
+    // Free the order key of the slot.
+    _orderCounts.Add(slot.orderKey, -1);
+    _orderTimes.Add(slot.orderKey, -slot.timeLeft);
+    _keySlots[slot.orderKey] = -1;
+    slot.orderKey = -1;
+    _queueListChanged = true;
+
+    // Point the neighbours, or the queue ends, past the slot.
+    if (slot.previousSlot >= 0)
     {
-        return 1;
+        _slotStates[slot.previousSlot].nextSlot = slot.nextSlot;
+    }
+    else
+    {
+        _frontSlot = slot.nextSlot;
     }
 
-    // Return progress of current item.
-    return irr::core::clamp(_currentItemTimer / _queue.front()->GetQueueTime(), 0.f, 1.f);
+    if (slot.nextSlot >= 0)
+    {
+        _slotStates[slot.nextSlot].previousSlot = slot.previousSlot;
+    }
+    else
+    {
+        _backSlot = slot.previousSlot;
+    }
+
+    slot.previousSlot = -1;
+    slot.nextSlot = -1;
 }
 
 /**
- * @brief Returns a const pointer to the internal vector of enqueued items.
+ * @brief Returns the slot the given handle refers to, or -1 if its item is
+ * no longer enqueued in this build queue.
  * 
- * @return const std::vector<IQueueItem *>* const A const pointer to the build queue.
+ * @param handle The handle to resolve.
+ * @return int The slot of the item the handle refers to.
  */
-const std::vector<BuildQueue::IQueueItem *>* const BuildQueue::GetQueueList()
+int BuildQueue::GetSlot(ItemHandle handle)
 {
-    return &_queue;
+    // Make sure the handle points at an occupied slot of this queue.
+    if (handle.slotIndex < 0 || handle.slotIndex >= _queueCapacity)
+    {
+        return -1;
+    }
+
+    // Make sure the slot wasn't freed since the handle was handed out.
+    SlotState &slot = _slotStates[handle.slotIndex];
+    if (!slot.item || slot.generation != handle.generation)
+    {
+        return -1;
+    }
+
+    return handle.slotIndex;
 }
 
 /**
- * @brief: Updates the queue timer and handles dequeueing at the right time.
+ * @brief Allocates the item storage for the given capacity.
+ * Only call this while the queue is empty.
+ * 
+ * @param queueCapacity The maximum capacity of the queue.
  */
-void BuildQueue::Update()
+void BuildQueue::AllocateSlots(int queueCapacity)
 {
-    // If the queue is empty, return.
-    if (_queue.size() == 0)
+    _queueCapacity = queueCapacity;
+
+    _queue.reserve(_queueCapacity);
+    _itemSlots.resize(_queueCapacity);
+
+    // Never drop slot states, so a slot that comes back after the capacity shrunk
+    // and grew again keeps its generation, and old handles to it stay invalid.
+    if (static_cast<int>(_slotStates.size()) < _queueCapacity)
     {
-        return;
+        _slotStates.resize(_queueCapacity);
     }
+    _freeSlots.clear();
+    _freeSlots.reserve(_queueCapacity);
 
-    // Increment timer for the current item.
-    _currentItemTimer += GameTime::GetDeltaTime();
+    // Leave room for several times the capacity at either end of the order keys.
+    int keyCount = 4 * _queueCapacity + 4;
+    _keySlots.assign(keyCount, -1);
+    _orderCounts.Reset(keyCount);
+    _orderTimes.Reset(keyCount);
 
-    // Update queue progress bar.
-    HeadsUpDisplay::GetInstance()->UpdateBuildQueueProgressBar(this);
+    // Push free slots in reverse, so the first enqueue takes slot 0.
+    for (int i = _queueCapacity - 1; i >= 0; i--)
+    {
+        _freeSlots.push_back(i);
+    }
+}
 
-    // Check if the timer for the current item has finished.
-    if (_currentItemTimer >= _queue.front()->GetQueueTime())
+/**
+ * @brief Removes all items from the queue without calling their cancel functions.
+ */
+void BuildQueue::Clear()
+{
+    // Keep destroying the front item until the queue is empty.
+    while (_frontSlot >= 0)
     {
-        PopCurrentItem();
-        _currentItemTimer = 0;
+        DestroyItem(_frontSlot);
     }
 }
 
 /**
- * @brief Pops the current item from the build queue, and makes the second item
- * the first. Also calls the finish function on the popped item and resets the timer.
+ * @brief Gives the given slot the given order key, and adds it to the order trees.
+ * 
+ * @param slotIndex The slot to add.
+ * @param orderKey The unused key to give the slot.
  */
-void BuildQueue::PopCurrentItem()
+void BuildQueue::InsertIntoOrder(int slotIndex, int orderKey)
 {
-    // Call finish function on the current item before popping it from the queue.
-    _queue.front()->OnBuildQueueFinish();
+    SlotState &slot = _slotStates[slotIndex];
 
-    // Decrement the queue indices for all enqueued items, because they have
-    // all been moved ahead by 1 spot.
-    DecrementIndices(0);
+    // Items waiting for a lane only have progress if they were moved back,
+    // and that progress is kept until they get a lane again.
+    slot.timeLeft = std::max(slot.duration - slot.timer, 0.f);
+    slot.orderKey = orderKey;
+    _keySlots[orderKey] = slotIndex;
 
-    // Delete the current item.
-    delete (_queue.front());
+    _orderCounts.Add(orderKey, 1);
+    _orderTimes.Add(orderKey, slot.timeLeft);
+    _queueListChanged = true;
+}
+
+/**
+ * @brief Spreads the order keys of the linked slots evenly around the middle
+ * of the key range, and rebuilds the order trees. Called when an end of the
+ * key range is reached, which happens at most once every capacity links, so
+ * linking stays O(log n) amortized.
+ */
+void BuildQueue::RenumberOrder()
+{
+    int itemCount = 0;
+    for (int slotIndex = _frontSlot; slotIndex >= 0; slotIndex = _slotStates[slotIndex].nextSlot)
+    {
+        itemCount++;
+    }
 
-    // Erase the current item.
-    _queue.erase(_queue.begin());
+    std::fill(_keySlots.begin(), _keySlots.end(), -1);
+    _orderCounts.Reset(_orderCounts.GetSize());
+    _orderTimes.Reset(_orderTimes.GetSize());
 
-    // Refresh queue UI.
-    HeadsUpDisplay::GetInstance()->UpdateBuildQueueOrder(this);
+    // Hand out consecutive keys, centered so both ends have the same room left.
+    int orderKey = (static_cast<int>(_keySlots.size()) - itemCount) / 2;
+    for (int slotIndex = _frontSlot; slotIndex >= 0; slotIndex = _slotStates[slotIndex].nextSlot)
+    {
+        SlotState &slot = _slotStates[slotIndex];
+        slot.orderKey = orderKey++;
+        _keySlots[slot.orderKey] = slotIndex;
+
+        _orderCounts.Add(slot.orderKey, 1);
+        _orderTimes.Add(slot.orderKey, slot.timeLeft);
+    }
+}
+
+/**
+ * @brief Updates the time left of the item in the given slot, and the order
+ * trees with it, after its timer changed.
+ * 
+ * @param slotIndex The slot of the item.
+ */
+void BuildQueue::RefreshTimeLeft(int slotIndex)
+{
+    SlotState &slot = _slotStates[slotIndex];
+    float timeLeft = std::max(slot.duration - slot.timer, 0.f);
+
+    _orderTimes.Add(slot.orderKey, static_cast<double>(timeLeft) - slot.timeLeft);
+    slot.timeLeft = timeLeft;
 }
 
 /**
- * @brief Decrements the indices of all items after the given starting index,
- * which should correspond to the item that is about to be deleted.
- * This is necessary for the queue indices to remain consistent for all items
- * in the queue.
+ * @brief Returns the index in the queue of the item in the given slot.
  * 
- * Call this BEFORE removing an item, otherwise the first item will be skipped.
+ * @param slotIndex The slot of the item.
+ * @return int The index of the item in the queue, 0 being the current item.
+ */
+int BuildQueue::GetQueueIndex(int slotIndex)
+{
+    // The items in front of it are the ones with a lower key.
+    return _orderCounts.GetSum(_slotStates[slotIndex].orderKey);
+}
+
+/**
+ * @brief Returns the slot of the item at the given index in the queue.
  * 
- * @param removedItemIndex The index of the item that is about to be removed.
+ * @param queueIndex The index of the item in the queue, 0 being the current item.
+ * @return int The slot of the item, -1 if there is no item at the index.
  */
-void BuildQueue::DecrementIndices(int removedItemIndex)
+int BuildQueue::GetSlotAt(int queueIndex)
 {
-    // Loop over all items after the given index.
-    for (int i = removedItemIndex + 1; i < _queue.size(); i++)
+    if (queueIndex < 0)
     {
-        // Decrement queue index.
-        _queue.at(i)->_queueIndex--;
+        return -1;
     }
+
+    // The item is at the first key with more than queueIndex items up to it.
+    int orderKey = _orderCounts.FindIndexAfterSum(queueIndex);
+    return orderKey < static_cast<int>(_keySlots.size()) ? _keySlots[orderKey] : -1;
 }
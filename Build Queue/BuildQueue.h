@@ -8,30 +8,68 @@
 #pragma once
 
 #include <vector>
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include <irrlicht.h>
 
 #include <GameTime.h>
 #include <IUpdatable.h>
+#include <InplaceCallback.h>
+#include <ConcurrentRingBuffer.h>
+#include <FenwickTree.h>
+
+#include "BuildQueueTelemetry.h"
 
 class HeadsUpDisplay;
 
 /**
- * @brief: Manages a build queue, represented internally by a vector list for
- * versatility. Enqueue an IQueueItem, which contains functions that manage how
- * it is handled by the BuildQueue.
+ * @brief: Manages a build queue. Enqueue an IQueueItem, which contains functions
+ * that manage how it is handled by the BuildQueue.
+ *
+ * Enqueued items are constructed in fixed-size slots owned by the queue, so
+ * enqueueing, cancelling and finishing items never touches the heap.
+ * The slots are linked together in queue order, and every item gets an order key
+ * that only grows towards the back of the queue. Prefix sums over those keys
+ * count the items and add up their remaining times, so items can be cancelled
+ * and moved around through an ItemHandle, and their queue index and remaining
+ * time looked up, in O(log n) without re-indexing the items behind them.
+ *
+ * A queue can have several lanes, in which case the first items in the queue
+ * are all in production at the same time, one per lane.
+ *
+ * All functions must be called from the main thread, except for the Submit
+ * functions, which let other threads (like AI planners) queue up commands that
+ * are applied at the start of the next Update.
  */
 class BuildQueue : public IUpdatable
 {
 public:
     /**
-     * @brief Constructs a BuildQueue.
-     * Maximum queue capacity can be specified.
+     * @brief Constructs a BuildQueue that reports its changes to the HeadsUpDisplay.
+     * Maximum queue capacity and number of lanes can be specified.
+     * 
+     * @param queueCapacity The maximum capacity of the queue.
+     * @param laneCount The number of items that are in production at the same time.
+     */
+    BuildQueue(int queueCapacity, int laneCount = 1);
+
+    /**
+     * @brief Constructs a BuildQueue that reports its changes to the given
+     * HeadsUpDisplay, or to none at all if it is null.
      * 
      * @param queueCapacity The maximum capacity of the queue.
+     * @param laneCount The number of items that are in production at the same time.
+     * @param headsUpDisplay The HUD to show the queue in, or null to show it nowhere.
+     * @param addToGameWorld Whether the GameWorld updates the queue. Pass false for
+     * queues whose owner calls Update itself, like benchmark queues.
      */
-    BuildQueue(int queueCapacity);
+    BuildQueue(int queueCapacity, int laneCount, HeadsUpDisplay *headsUpDisplay,
+               bool addToGameWorld = true);
 
     /**
      * @brief Delete all remaining queue items upon deletion of
@@ -39,6 +77,18 @@ public:
      */
     ~BuildQueue();
 
+    /**
+     * @brief The maximum size in bytes of an item enqueued on a BuildQueue.
+     * Item classes bigger than this are rejected at compile time by Enqueue.
+     */
+    static const std::size_t ITEM_SLOT_SIZE = 128;
+
+    /**
+     * @brief The type id of items that can't be serialized.
+     * Can't be registered with RegisterItemType.
+     */
+    static const unsigned short NO_ITEM_TYPE_ID = 0xFFFF;
+
     /**
      * @brief Represents an item that can be enqueued in a BuildQueue.
      * Implement this in a class you want to enqueue on the BuildQueue.
@@ -50,6 +100,7 @@ public:
 
         /**
          * @brief How long the item takes to finish the queue when it is active.
+         * Read once when the item is enqueued, so it must not change afterwards.
          */
         virtual float GetQueueTime() = 0;
 
@@ -59,14 +110,23 @@ public:
         virtual irr::video::ITexture *GetBuildQueueButtonImage() = 0;
 
         /**
-         * @brief Returns the index of the item in the queue + 1,
-         * so it starts counting up from 1 at the start of the queue.
+         * @brief The id this item type was registered under with
+         * BuildQueue::RegisterItemType. Used to serialize the item.
+         * Defaults to NO_ITEM_TYPE_ID, in which case queues holding the item
+         * can't be serialized. Override this to opt in to serialization.
          */
-        int GetQueueIndex()
+        virtual unsigned short GetItemTypeId()
         {
-            return _queueIndex + 1;
+            return NO_ITEM_TYPE_ID;
         };
 
+        /**
+         * @brief Returns the index of the item in the queue + 1,
+         * so it starts counting up from 1 at the start of the queue.
+         * 0 if the item isn't enqueued. Takes O(log n).
+         */
+        int GetQueueIndex();
+
     protected:
         /**
          * @brief The function that verifies whether the item can be enqueued or not.
@@ -75,6 +135,30 @@ public:
          */
         virtual bool OnBuildQueueStart() = 0;
 
+        /**
+         * @brief Returned by OnBuildQueueStartBatch to have every copy in the batch
+         * verified by its own OnBuildQueueStart call instead.
+         */
+        static const int VALIDATE_EACH_ITEM = -1;
+
+        /**
+         * @brief Verifies how many copies of this item can be enqueued at once.
+         * Called on the first copy when a batch of items is enqueued, so checks like
+         * spending resources can be done for the whole batch in one go. Must return
+         * the number of copies that may be enqueued, at most count. The copies
+         * accepted this way never get an OnBuildQueueStart call of their own.
+         * 
+         * Defaults to VALIDATE_EACH_ITEM, so every copy is constructed and verified
+         * with its own OnBuildQueueStart, until one of them fails.
+         * 
+         * @param count The number of copies that were requested.
+         * @return int The number of copies that may be enqueued, or VALIDATE_EACH_ITEM.
+         */
+        virtual int OnBuildQueueStartBatch(int count)
+        {
+            return VALIDATE_EACH_ITEM;
+        };
+
         /**
          * @brief Called when this item is cancelled in the build queue.
          */
@@ -84,48 +168,273 @@ public:
         friend class BuildQueue;
         
         /**
-         * @brief Holds the actual index of the item in the build queue.
-         * 0 when it is the first item in the queue.
+         * @brief Index of the storage slot the item was constructed in.
+         * -1 until the item is enqueued.
+         */
+        int _slotIndex = -1;
+
+        /**
+         * @brief The build queue the item is enqueued in, null until it is enqueued.
          */
-        int _queueIndex;
+        BuildQueue *_buildQueue = nullptr;
         
         /**
          * @brief Called when the item finishes the queue, after which it is popped from it.
          */
-        std::function<void()> OnBuildQueueFinish;
+        InplaceCallback OnBuildQueueFinish;
 
         /**
-         * @brief Initializes the IQueueItem with an index and finish function.
+         * @brief Initializes the IQueueItem with its finish function.
          * 
-         * @param index Index in the build queue.
          * @param finishFunction Function to call upon being popped from the build queue.
          */
-        void Initialize(int index, std::function<void()> finishFunction)
+        void Initialize(InplaceCallback &finishFunction)
         {
-            _queueIndex = index;
-            OnBuildQueueFinish = finishFunction;
+            OnBuildQueueFinish = std::move(finishFunction);
         };
     };
 
     /**
-     * @brief Attempt to enqueue the given item. If the item's OnBuildQueueStart
-     * function evaluates to false, or the queue is full, this function will end
-     * and return false. Returns true upon a successful enqueue.
+     * @brief Refers to an enqueued item. Stays valid while the item is in the
+     * queue, and is safely rejected by the queue once the item is gone, even
+     * when its slot has been reused by another item since.
+     */
+    struct ItemHandle
+    {
+        int slotIndex = -1;
+        unsigned int generation = 0;
+
+        /**
+         * @brief Returns whether the handle was handed out for an item at all.
+         * Use BuildQueue::GetItem to check whether the item is still enqueued.
+         */
+        explicit operator bool() const
+        {
+            return slotIndex >= 0;
+        };
+    };
+
+    /**
+     * @brief Constructs an item of a registered type in the given storage, and sets
+     * the function to call when it finishes the queue. Used to restore items from
+     * serialized queues and to apply submitted enqueue commands. The queue decides
+     * whether OnBuildQueueStart checks are performed, so don't perform them here.
+     * 
+     * @param storage The slot storage to construct the item in, ITEM_SLOT_SIZE bytes.
+     * @param context The context passed to Deserialize, like the queue's owner.
+     * @param finishFunction Set this to the function to call when the item finishes.
+     * @return IQueueItem* The constructed item.
+     */
+    typedef IQueueItem *(*ItemConstructor)(void *storage, void *context,
+                                           InplaceCallback &finishFunction);
+
+    /**
+     * @brief Registers the constructor for the item type with the given id, so
+     * serialized queues containing items of that type can be deserialized.
      * 
-     * @param item The item to enqueue.
+     * @param typeId The id of the item type, as returned by its GetItemTypeId.
+     * @param constructor The function that constructs an item of the type.
+     */
+    static void RegisterItemType(unsigned short typeId, ItemConstructor constructor);
+
+    /**
+     * @brief Attempt to enqueue an item of the given type, constructed in place
+     * from the given arguments. If the item's OnBuildQueueStart function evaluates
+     * to false, or the queue is full, this function will end and return an empty
+     * handle. Returns a handle to the item upon a successful enqueue.
+     * 
+     * @tparam ItemType The IQueueItem implementation to enqueue.
      * @param finishFunction The function to call when the item finishes the queue.
-     * @return bool Whether the item was successfully enqueued or not.
+     * @param arguments The arguments to construct the item with.
+     * @return ItemHandle A handle to the enqueued item, empty if the enqueue failed.
+     */
+    template <typename ItemType, typename... Arguments>
+    ItemHandle Enqueue(InplaceCallback finishFunction, Arguments &&... arguments)
+    {
+        static_assert(std::is_base_of<IQueueItem, ItemType>::value,
+                      "Only IQueueItem implementations can be enqueued.");
+        static_assert(sizeof(ItemType) <= ITEM_SLOT_SIZE,
+                      "Item type is too big to fit in a build queue slot.");
+        static_assert(alignof(ItemType) <= alignof(ItemSlot),
+                      "Item type alignment is too strict for a build queue slot.");
+
+        // Make sure there is still space left in the build queue.
+        if (_freeSlots.empty())
+        {
+            // Build queue capacity reached, so return an empty handle.
+            return ItemHandle();
+        }
+
+        // Construct the item in the next free slot, then let the queue validate it.
+        IQueueItem *item = new (&_itemSlots[_freeSlots.back()])
+            ItemType(std::forward<Arguments>(arguments)...);
+
+        return FinishEnqueue(item, finishFunction);
+    }
+
+    /**
+     * @brief Attempt to enqueue a batch of items of the given type, all constructed
+     * from the same arguments. The whole batch is validated in a single
+     * OnBuildQueueStartBatch call on the first item, or per item if that asks
+     * for it, and the queue UI is refreshed only once.
+     * Never enqueues more items than there is space left for in the queue.
+     * 
+     * @tparam ItemType The IQueueItem implementation to enqueue.
+     * @param count The number of items to enqueue.
+     * @param finishFunction The function to call when each item finishes the queue.
+     * @param arguments The arguments to construct each item with.
+     * @return int The number of items that were successfully enqueued.
      */
-    bool Enqueue(IQueueItem *item, std::function<void()> finishFunction);
+    template <typename ItemType, typename... Arguments>
+    int EnqueueBatch(int count, InplaceCallback finishFunction, const Arguments &... arguments)
+    {
+        static_assert(std::is_base_of<IQueueItem, ItemType>::value,
+                      "Only IQueueItem implementations can be enqueued.");
+        static_assert(sizeof(ItemType) <= ITEM_SLOT_SIZE,
+                      "Item type is too big to fit in a build queue slot.");
+        static_assert(alignof(ItemType) <= alignof(ItemSlot),
+                      "Item type alignment is too strict for a build queue slot.");
+
+        // Construct every item from the same arguments, with its own copy of the
+        // finish function.
+        auto constructItem = [&](void *storage, InplaceCallback &itemFinishFunction) -> IQueueItem *
+        {
+            itemFinishFunction = finishFunction;
+            return new (storage) ItemType(arguments...);
+        };
+
+        ItemHandle firstHandle;
+        int enqueuedCount = StartBatch(count, constructItem, firstHandle);
+
+        // Refresh queue UI once for the whole batch.
+        if (enqueuedCount > 0)
+        {
+            RecordEnqueued(enqueuedCount);
+            RefreshQueueOrder();
+        }
+
+        return enqueuedCount;
+    }
 
     /**
      * @brief Cancels the specified item in the build queue.
+     * Only pass items that are enqueued right now, like the ones in GetQueueList.
+     * Items live in reused slots, so a pointer to an item that left the queue may
+     * point at a newer item in the same slot. Keep an ItemHandle to refer to an
+     * item for longer instead.
      * 
      * @param item The item to cancel.
      * @return bool Whether the item was present and subsequently removed from the build queue.
      */
     bool Cancel(IQueueItem *item);
 
+    /**
+     * @brief Cancels the item the given handle refers to.
+     * 
+     * @param handle The handle of the item to cancel.
+     * @return bool Whether the item was present and subsequently removed from the build queue.
+     */
+    bool Cancel(ItemHandle handle);
+
+    /**
+     * @brief Moves the item the given handle refers to to the front of the queue,
+     * making it the current item. Progress on the previous current item is kept.
+     * 
+     * @param handle The handle of the item to move.
+     * @return bool Whether the item was present in the build queue.
+     */
+    bool MoveToFront(ItemHandle handle);
+
+    /**
+     * @brief Moves the item the given handle refers to to the back of the queue.
+     * Progress on the item is kept.
+     * 
+     * @param handle The handle of the item to move.
+     * @return bool Whether the item was present in the build queue.
+     */
+    bool MoveToBack(ItemHandle handle);
+
+    /**
+     * @brief Returns a handle to the given item, or an empty handle if the item
+     * isn't enqueued in this build queue. Like Cancel, only pass items that are
+     * enqueued right now. The handle stays safe to use after that.
+     * 
+     * @param item The item to get a handle for.
+     * @return ItemHandle A handle to the item.
+     */
+    ItemHandle GetHandle(IQueueItem *item);
+
+    /**
+     * @brief Returns the item the given handle refers to, or null if that item
+     * is no longer enqueued in this build queue.
+     * 
+     * @param handle The handle of the item to get.
+     * @return IQueueItem* The item the handle refers to.
+     */
+    IQueueItem *GetItem(ItemHandle handle);
+
+    /**
+     * @brief Receives the outcome of a command submitted from another thread.
+     * Owned by the submitter, and must stay alive until IsApplied returns true.
+     */
+    struct CommandResult
+    {
+        /**
+         * @brief The number of items that were enqueued or cancelled.
+         */
+        int itemCount = 0;
+
+        /**
+         * @brief For enqueue commands, a handle to the first enqueued item.
+         */
+        ItemHandle handle;
+
+        /**
+         * @brief Returns whether the build queue has applied the command, after
+         * which the other fields may be read. Safe to call from any thread.
+         */
+        bool IsApplied() const
+        {
+            return applied.load(std::memory_order_acquire);
+        };
+
+    private:
+        friend class BuildQueue;
+
+        /**
+         * @brief Set by the build queue after it filled in the other fields.
+         */
+        std::atomic<bool> applied{false};
+    };
+
+    /**
+     * @brief Submits a command to enqueue a batch of items of a registered type.
+     * The items are constructed with the registered constructor and validated
+     * with OnBuildQueueStartBatch at the start of the next Update.
+     * Safe to call from any thread.
+     * 
+     * @param typeId The id the item type was registered under.
+     * @param count The number of items to enqueue.
+     * @param context Passed to the registered item constructor.
+     * @param result Optional result to fill in once the command is applied.
+     * @return bool Whether the command was submitted. False if too many commands
+     * are already waiting to be applied.
+     */
+    bool SubmitEnqueue(unsigned short typeId, int count, void *context,
+                       CommandResult *result = nullptr);
+
+    /**
+     * @brief Submits a command to cancel the item the given handle refers to.
+     * The item is cancelled at the start of the next Update, if it is still enqueued.
+     * Safe to call from any thread.
+     * 
+     * @param handle The handle of the item to cancel.
+     * @param result Optional result to fill in once the command is applied.
+     * @return bool Whether the command was submitted. False if too many commands
+     * are already waiting to be applied.
+     */
+    bool SubmitCancel(ItemHandle handle, CommandResult *result = nullptr);
+
     /**
      * @brief Returns the progress of the current item in the queue.
      * 
@@ -134,49 +443,558 @@ public:
      */
     float GetCurrentItemProgress();
 
+    /**
+     * @brief Returns the progress of the item in the given lane.
+     * Lane 0 holds the current item, lane 1 the item behind it, and so on.
+     * 
+     * @param lane The lane to get the progress for.
+     * @return float A number between 0 and 1 indicating the progress of the
+     * item in the lane. 1 if there is no item in the lane.
+     */
+    float GetLaneProgress(int lane);
+
+    /**
+     * @brief Returns the number of items that are in production at the same time.
+     * 
+     * @return int The number of lanes of the queue.
+     */
+    int GetLaneCount();
+
+    /**
+     * @brief Returns the production counters of this queue since it was created.
+     * Use BuildQueueTelemetry::GetGlobalStatistics for the counters of all queues.
+     * 
+     * @return const BuildQueueStatistics& The counters of this queue.
+     */
+    const BuildQueueStatistics &GetStatistics();
+
+    /**
+     * @brief Sets whether the queue adds its counters to the global counters of
+     * BuildQueueTelemetry, which it does by default. Turn this off for queues that
+     * aren't part of the game, like benchmark queues. Its own counters are kept
+     * either way. Set it before other threads submit commands to the queue.
+     * 
+     * @param reportsTelemetry Whether to add to the global counters.
+     */
+    void SetReportsTelemetry(bool reportsTelemetry);
+
+    /**
+     * @brief Returns the time in seconds until the item at the given index in the
+     * queue finishes, including the time needed for all items in front of it.
+     * Takes O(log n) with a single lane. With several lanes the items in front
+     * are scheduled one by one, so it takes time linear in the index.
+     * 
+     * @param queueIndex The index of the item in the queue, 0 being the current item.
+     * @return float The remaining time in seconds until the item finishes.
+     * 0 if there is no item at the index.
+     */
+    float GetItemTimeRemaining(int queueIndex);
+
+    /**
+     * @brief Returns the time in seconds until all items in the queue are finished.
+     * Takes O(log n) with a single lane, and walks the queue with several lanes.
+     * 
+     * @return float The remaining time in seconds until the queue is empty.
+     */
+    float GetTotalTimeRemaining();
+
+    /**
+     * @brief Fills the given list with the remaining time in seconds until each item
+     * in the queue finishes, in queue order.
+     * 
+     * @param timesRemaining The list to fill. Existing contents are replaced.
+     */
+    void GetTimesRemaining(std::vector<float> &timesRemaining);
+
     /**
      * @brief Returns a const pointer to the internal vector of enqueued items.
+     * The vector is only brought up to date by this call, walking the queue if it
+     * changed since the last call, so fetch it again after changing the queue.
      * 
      * @return const std::vector<IQueueItem *>* const A const pointer to the build queue.
      */
     const std::vector<IQueueItem *>* const GetQueueList();
 
+    /**
+     * @brief Returns the exact number of bytes Serialize will append for this
+     * queue's current state. Sum this over all queues to reserve a save buffer once.
+     * 
+     * @return std::size_t The serialized size of the queue in bytes.
+     */
+    std::size_t GetSerializedSize();
+
+    /**
+     * @brief Appends the state of the queue to the given buffer, in a compact,
+     * versioned, little endian binary format: the capacity and lane count, then the
+     * type id and timer of each item in queue order. Finish functions are not
+     * serialized; they are restored by the registered item constructors.
+     * 
+     * @param buffer The buffer to append the queue state to.
+     * @return bool Whether the queue could be serialized. False if the capacity or
+     * lane count doesn't fit the format, or an item has no type id, in which case
+     * the buffer is left unchanged.
+     */
+    bool Serialize(std::vector<unsigned char> &buffer);
+
+    /**
+     * @brief Replaces the state of the queue with the state serialized at the given
+     * position, and advances the position past it. Existing items are removed
+     * without calling their cancel functions, and restored items are not asked
+     * to perform their OnBuildQueueStart checks.
+     * 
+     * @param data The position to read from. Advanced past the queue state on success.
+     * @param end The end of the serialized data.
+     * @param context Passed to the registered item constructors, like the queue's owner.
+     * @return bool Whether the queue state was read successfully. The queue is left
+     * empty if it wasn't.
+     */
+    bool Deserialize(const unsigned char *&data, const unsigned char *end, void *context);
+
     /**
      * @brief: Updates the queue timer and handles dequeueing at the right time.
      */
     virtual void Update() override;
 
 private:
+    /**
+     * @brief The version of the format written by Serialize.
+     * Increment this whenever the format changes.
+     */
+    static const unsigned short SERIALIZATION_VERSION = 2;
+
+    /**
+     * @brief The registered item constructors, indexed by item type id.
+     */
+    static std::vector<ItemConstructor> _itemConstructors;
+
+    /**
+     * @brief The maximum number of submitted commands waiting to be applied.
+     */
+    static const std::size_t COMMAND_CAPACITY = 16;
+
+    /**
+     * @brief A command submitted from another thread.
+     */
+    struct Command
+    {
+        enum Type
+        {
+            eEnqueue,
+            eCancel
+        };
+
+        Type type;
+        // Enqueue commands.
+        unsigned short typeId;
+        int count;
+        void *context;
+        // Cancel commands.
+        ItemHandle handle;
+        // Optional result to fill in, owned by the submitter.
+        CommandResult *result;
+    };
+
+    /**
+     * @brief The commands waiting to be applied at the start of the next Update.
+     */
+    ConcurrentRingBuffer<Command, COMMAND_CAPACITY> _commands;
+
     /**
      * @brief Max number of concurrent items in the build queue.
      */
     int _queueCapacity;
 
     /**
-     * @brief Holds the timer value for the currently active item in the queue.
+     * @brief The HUD the queue reports its changes to, or null if none.
      */
-    float _currentItemTimer;
+    HeadsUpDisplay *_headsUpDisplay;
 
     /**
-     * @brief The internal vector. This is the "build queue" itself, essentially.
+     * @brief The production counters of this queue.
+     */
+    BuildQueueStatistics _statistics;
+
+    /**
+     * @brief Whether the queue adds its counters to the global counters.
+     */
+    bool _reportsTelemetry = true;
+
+    /**
+     * @brief The items in queue order, as returned by GetQueueList. Only rebuilt
+     * from the slot links when it is asked for after the queue changed.
      */
     std::vector<IQueueItem *> _queue = {};
 
     /**
-     * @brief Pops the current item from the build queue, and makes the second item
-     * the first. Also calls the finish function on the popped item and resets the timer.
+     * @brief Whether the queue changed since _queue was last rebuilt.
+     */
+    bool _queueListChanged = false;
+
+    /**
+     * @brief The number of items that are in production at the same time.
+     */
+    int _laneCount = 1;
+
+    /**
+     * @brief When each lane becomes free, while scheduling items on the lanes.
+     */
+    std::vector<float> _laneFinishTimes = {};
+
+    /**
+     * @brief The items that finished during the current Update, at most one per lane.
+     */
+    std::vector<ItemHandle> _finishedItems = {};
+
+    /**
+     * @brief Bookkeeping for a single item slot.
+     */
+    struct SlotState
+    {
+        // The item constructed in the slot, or null if the slot is free.
+        IQueueItem *item = nullptr;
+        // Incremented every time the slot is freed, to invalidate old handles.
+        unsigned int generation = 0;
+        // Slots of the items before and after this one in the queue, -1 if none.
+        int previousSlot = -1;
+        int nextSlot = -1;
+        // Cached queue time of the item.
+        float duration = 0;
+        // Time the item has spent being the current item.
+        float timer = 0;
+        // The time left until the item finishes once it has a lane, as added to
+        // _orderTimes. Kept up to date by Update for the items in the lanes.
+        float timeLeft = 0;
+        // The key of the item in the order trees, -1 if the slot is free. Keys
+        // grow from the front to the back of the queue, but may have gaps.
+        int orderKey = -1;
+    };
+
+    /**
+     * @brief Bookkeeping for all item slots, indexed like _itemSlots.
+     * Never shrinks, so it may hold states past the capacity.
      */
-    void PopCurrentItem();
+    std::vector<SlotState> _slotStates = {};
 
     /**
-     * @brief Decrements the indices of all items after the given starting index,
-     * which should correspond to the item that is about to be deleted.
-     * This is necessary for the queue indices to remain consistent for all items
-     * in the queue.
+     * @brief Slots of the first and last items in the queue, -1 if the queue is empty.
+     */
+    int _frontSlot = -1;
+    int _backSlot = -1;
+
+    /**
+     * @brief The slot of the item with each order key, -1 if no item has the key.
+     * Has room for several times the capacity, so items can be linked in at
+     * either end many times before the keys have to be renumbered.
+     */
+    std::vector<int> _keySlots = {};
+
+    /**
+     * @brief One for every order key in use, so the prefix sum up to an item's
+     * key is its index in the queue.
+     */
+    FenwickTree<int> _orderCounts;
+
+    /**
+     * @brief The time left of the item with each order key, so with a single lane
+     * the prefix sum up to and including an item's key is its remaining time.
+     */
+    FenwickTree<double> _orderTimes;
+
+    /**
+     * @brief Raw storage for a single enqueued item.
+     */
+    typedef typename std::aligned_storage<ITEM_SLOT_SIZE, alignof(std::max_align_t)>::type ItemSlot;
+
+    /**
+     * @brief Storage for all items in the queue, one slot per unit of capacity.
+     */
+    std::vector<ItemSlot> _itemSlots = {};
+
+    /**
+     * @brief Indices of the slots in _itemSlots that don't hold an item.
+     */
+    std::vector<int> _freeSlots = {};
+
+    /**
+     * @brief Finishes enqueueing an item that was just constructed in the last free slot.
+     * Destroys the item again if its OnBuildQueueStart function evaluates to false.
      * 
-     * Call this BEFORE removing an item, otherwise the first item will be skipped.
+     * @param item The item that was constructed in the slot.
+     * @param finishFunction The function to call when the item finishes the queue.
+     * @return ItemHandle A handle to the enqueued item, empty if the enqueue failed.
+     */
+    ItemHandle FinishEnqueue(IQueueItem *item, InplaceCallback &finishFunction);
+
+    /**
+     * @brief Constructs, validates and pushes a batch of items, one free slot at a
+     * time. The first item validates the batch with OnBuildQueueStartBatch, unless
+     * it asks for every item to be validated with its own OnBuildQueueStart.
+     * An item that isn't enqueued is destroyed again. Only the first item is
+     * constructed before the batch is validated, so no item past the count the
+     * validation allowed is ever constructed. Never enqueues more items
+     * than there is space left for, and doesn't refresh the queue UI.
+     * 
+     * @param count The number of items in the batch.
+     * @param constructItem Called as constructItem(storage, finishFunction) to
+     * construct the next item in the given slot storage, and to set the function
+     * to call when it finishes the queue.
+     * @param firstHandle Set to a handle to the first enqueued item.
+     * @return int The number of items that were successfully enqueued.
+     */
+    template <typename ConstructItem>
+    int StartBatch(int count, ConstructItem &constructItem, ItemHandle &firstHandle)
+    {
+        // Never try to enqueue more items than there is space left for.
+        count = std::min(count, static_cast<int>(_freeSlots.size()));
+        bool validateEachItem = false;
+
+        // The first item decides the final count, and the loop condition checks it
+        // before any further item is constructed.
+        for (int i = 0; i < count; i++)
+        {
+            InplaceCallback finishFunction;
+            IQueueItem *item = constructItem(&_itemSlots[_freeSlots.back()], finishFunction);
+
+            // Let the first item decide how the batch is validated.
+            if (i == 0)
+            {
+                int batchCount = item->OnBuildQueueStartBatch(count);
+                validateEachItem = batchCount == IQueueItem::VALIDATE_EACH_ITEM;
+                if (!validateEachItem && batchCount <= 0)
+                {
+                    // The whole batch was rejected, so destroy the item that was asked.
+                    item->~IQueueItem();
+                    return 0;
+                }
+                else if (!validateEachItem)
+                {
+                    count = std::min(batchCount, count);
+                }
+            }
+
+            // Make sure the requirements for this item are met.
+            if (validateEachItem && !item->OnBuildQueueStart())
+            {
+                // Requirements not met, so destroy the item again and stop.
+                item->~IQueueItem();
+                return i;
+            }
+
+            ItemHandle handle = PushItem(item, std::move(finishFunction));
+            if (i == 0)
+            {
+                firstHandle = handle;
+            }
+        }
+
+        return std::max(count, 0);
+    }
+
+    /**
+     * @brief Claims the last free slot for the given item, which must have been
+     * constructed in it, and pushes the item to the back of the queue.
      * 
-     * @param removedItemIndex The index of the item that is about to be removed.
+     * @param item The item to push.
+     * @param finishFunction The function to call when the item finishes the queue.
+     * @return ItemHandle A handle to the pushed item.
      */
-    void DecrementIndices(int removedItemIndex);
+    ItemHandle PushItem(IQueueItem *item, InplaceCallback finishFunction);
+
+    /**
+     * @brief Refreshes the queue UI after the order of the queue changed.
+     */
+    void RefreshQueueOrder();
+
+    /**
+     * @brief Records the given number of enqueued items, in both the counters
+     * of this queue and the global counters.
+     * 
+     * @param itemCount The number of items that were enqueued.
+     */
+    void RecordEnqueued(int itemCount);
+
+    /**
+     * @brief Records the given number of cancelled items, in both the counters
+     * of this queue and the global counters.
+     * 
+     * @param itemCount The number of items that were cancelled.
+     */
+    void RecordCancelled(int itemCount);
+
+    /**
+     * @brief Refreshes the queue UI after the progress of the queue changed.
+     */
+    void RefreshQueueProgress();
+
+    /**
+     * @brief Applies all submitted commands, in the order they were submitted.
+     * Refreshes the queue UI once if any of them changed the queue.
+     */
+    void ApplyCommands();
+
+    /**
+     * @brief Enqueues a batch of items of a registered type, constructed with the
+     * registered constructor and validated with OnBuildQueueStartBatch.
+     * Doesn't refresh the queue UI.
+     * 
+     * @param typeId The id the item type was registered under.
+     * @param count The number of items to enqueue.
+     * @param context Passed to the registered item constructor.
+     * @param firstHandle Set to a handle to the first enqueued item.
+     * @return int The number of items that were successfully enqueued.
+     */
+    int EnqueueRegistered(unsigned short typeId, int count, void *context,
+                          ItemHandle &firstHandle);
+
+    /**
+     * @brief Reads the state serialized at the given position into the empty queue,
+     * and advances the position past it. Doesn't refresh the queue UI, and may leave
+     * some restored items behind if it fails.
+     * 
+     * @param data The position to read from. Advanced past the queue state on success.
+     * @param end The end of the serialized data.
+     * @param context Passed to the registered item constructors.
+     * @return bool Whether the queue state was read successfully.
+     */
+    bool ReadState(const unsigned char *&data, const unsigned char *end, void *context);
+
+    /**
+     * @brief Calls the finish function on the item in the given slot, then removes
+     * it from the build queue, so the next waiting item can take its lane.
+     * 
+     * @param slotIndex The slot of the item that finished.
+     */
+    void FinishItem(int slotIndex);
+
+    /**
+     * @brief Unlinks the item in the given slot from the queue, destroys it and
+     * frees the slot.
+     * 
+     * @param slotIndex The slot of the item to destroy.
+     */
+    void DestroyItem(int slotIndex);
+
+    /**
+     * @brief Links the given slot in at the front of the queue, with an order
+     * key below the current front item.
+     * 
+     * @param slotIndex The slot to link.
+     */
+    void LinkAtFront(int slotIndex);
+
+    /**
+     * @brief Links the given slot in at the back of the queue, with an order
+     * key above the current back item.
+     * 
+     * @param slotIndex The slot to link.
+     */
+    void LinkAtBack(int slotIndex);
+
+    /**
+     * @brief Unlinks the given slot from its neighbours in the queue, and
+     * removes it from the order trees.
+     * 
+     * @param slotIndex The slot to unlink.
+     */
+    void Unlink(int slotIndex);
+
+    /**
+     * @brief Returns the slot the given handle refers to, or -1 if its item is
+     * no longer enqueued in this build queue.
+     * 
+     * @param handle The handle to resolve.
+     * @return int The slot of the item the handle refers to.
+     */
+    int GetSlot(ItemHandle handle);
+
+    /**
+     * @brief Allocates the item storage for the given capacity.
+     * Only call this while the queue is empty.
+     * 
+     * @param queueCapacity The maximum capacity of the queue.
+     */
+    void AllocateSlots(int queueCapacity);
+
+    /**
+     * @brief Removes all items from the queue without calling their cancel functions.
+     */
+    void Clear();
+
+    /**
+     * @brief Gives the given slot the given order key, and adds it to the order trees.
+     * 
+     * @param slotIndex The slot to add.
+     * @param orderKey The unused key to give the slot.
+     */
+    void InsertIntoOrder(int slotIndex, int orderKey);
+
+    /**
+     * @brief Spreads the order keys of the linked slots evenly around the middle
+     * of the key range, and rebuilds the order trees. Called when an end of the
+     * key range is reached, which happens at most once every capacity links, so
+     * linking stays O(log n) amortized.
+     */
+    void RenumberOrder();
+
+    /**
+     * @brief Updates the time left of the item in the given slot, and the order
+     * trees with it, after its timer changed.
+     * 
+     * @param slotIndex The slot of the item.
+     */
+    void RefreshTimeLeft(int slotIndex);
+
+    /**
+     * @brief Returns the index in the queue of the item in the given slot.
+     * 
+     * @param slotIndex The slot of the item.
+     * @return int The index of the item in the queue, 0 being the current item.
+     */
+    int GetQueueIndex(int slotIndex);
+
+    /**
+     * @brief Returns the slot of the item at the given index in the queue.
+     * 
+     * @param queueIndex The index of the item in the queue, 0 being the current item.
+     * @return int The slot of the item, -1 if there is no item at the index.
+     */
+    int GetSlotAt(int queueIndex);
+
+    /**
+     * @brief Schedules the first items in the queue on the lanes, in queue order,
+     * and calls visit(finishTime) for each with the time in seconds until it
+     * finishes. The first items get a lane each, and every item after them waits
+     * for the lane that becomes free first.
+     * 
+     * @param itemCount The number of items to schedule, from the front of the queue.
+     * @param visit Called with the finish time of each item.
+     */
+    template <typename Visit>
+    void ScheduleLanes(int itemCount, Visit &visit)
+    {
+        int slotIndex = _frontSlot;
+        for (int i = 0; i < itemCount && slotIndex >= 0; i++)
+        {
+            SlotState &slot = _slotStates[slotIndex];
+            float finishTime;
+
+            if (i < _laneCount)
+            {
+                // The item has a lane, so it is in production right now.
+                finishTime = slot.timeLeft;
+                _laneFinishTimes[i] = finishTime;
+            }
+            else
+            {
+                // The item waits for the lane that becomes free first.
+                float *firstFreeLane = &*std::min_element(_laneFinishTimes.begin(),
+                                                          _laneFinishTimes.end());
+                finishTime = *firstFreeLane + slot.timeLeft;
+                *firstFreeLane = finishTime;
+            }
+
+            visit(finishTime);
+            slotIndex = slot.nextSlot;
+        }
+    }
 };
@@ -0,0 +1,235 @@
+/**
+ * @brief: Contains the BuildQueueBenchmark class function implementations.
+ * @file BuildQueueBenchmark.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "BuildQueueBenchmark.h"
+#include "StringHelper.h"
+
+#include <memory>
+#include <vector>
+
+// The capacity of the queues in the per-operation benchmarks.
+#define QUEUE_CAPACITY 10
+// The capacity of the queues in the per-frame benchmarks.
+#define FRAME_QUEUE_CAPACITY 5
+// How many times each per-operation benchmark repeats its operation.
+#define OPERATION_COUNT 100000
+// How many frames each per-frame benchmark runs.
+#define FRAME_COUNT 100
+// Queue time of items that should never finish during a benchmark.
+#define ENDLESS_QUEUE_TIME 1e9f
+
+/**
+ * @brief: A queue item without any game logic, so only the queue is measured.
+ */
+class BenchmarkItem : public BuildQueue::IQueueItem
+{
+public:
+    BenchmarkItem(float queueTime) : _queueTime(queueTime)
+    {
+    }
+
+    virtual float GetQueueTime() override
+    {
+        return _queueTime;
+    }
+
+    virtual irr::video::ITexture *GetBuildQueueButtonImage() override
+    {
+        return nullptr;
+    }
+
+protected:
+    virtual bool OnBuildQueueStart() override
+    {
+        return true;
+    }
+
+    virtual void OnBuildQueueCancel() override
+    {
+    }
+
+private:
+    float _queueTime;
+};
+
+/**
+ * @brief: Runs the benchmarks when F9 is pressed.
+ */
+void BuildQueueBenchmark::Update()
+{
+    if (InputHandler::GetInstance()->IsKeyPressed(irr::KEY_F9))
+    {
+        RunAll();
+    }
+}
+
+/**
+ * @brief: Runs all benchmarks and prints the results to the console.
+ */
+void BuildQueueBenchmark::RunAll()
+{
+    BenchmarkHarness::PrintTitle("BuildQueue benchmark");
+
+    // Per-operation costs at every queue length.
+    for (int queueLength = 1; queueLength <= QUEUE_CAPACITY; queueLength++)
+    {
+        BenchmarkHarness::PrintResult(StringHelper::Format("Enqueue + Cancel, length %d", queueLength),
+                                      BenchmarkEnqueueCancel(queueLength));
+    }
+    for (int queueLength = 1; queueLength <= QUEUE_CAPACITY; queueLength++)
+    {
+        BenchmarkHarness::PrintResult(StringHelper::Format("Update, length %d", queueLength),
+                                      BenchmarkUpdate(queueLength));
+    }
+    BenchmarkHarness::PrintResult("Enqueue + Update with PopCurrentItem", BenchmarkPop());
+
+    // Per-frame costs for large numbers of queues.
+    for (int queueCount : {100, 1000, 10000})
+    {
+        BenchmarkHarness::PrintResult(StringHelper::Format("Frame, %d queues", queueCount),
+                                      BenchmarkFrame(queueCount, false));
+        BenchmarkHarness::PrintResult(StringHelper::Format("Frame, %d queues, cancel churn", queueCount),
+                                      BenchmarkFrame(queueCount, true));
+    }
+}
+
+/**
+ * @brief: Measures enqueueing an item and cancelling another item in a queue
+ * that holds the given number of items, including the order refresh the
+ * HUD would trigger.
+ * 
+ * @param queueLength: The number of items in the queue.
+ * @return BenchmarkHarness::Result: The cost of a single enqueue and cancel.
+ */
+BenchmarkHarness::Result BuildQueueBenchmark::BenchmarkEnqueueCancel(int queueLength)
+{
+    std::unique_ptr<BuildQueue> queue(CreateQueue(QUEUE_CAPACITY));
+
+    // Fill the queue, keeping the handles around to cancel items by.
+    std::vector<BuildQueue::ItemHandle> handles;
+    for (int i = 0; i < queueLength; i++)
+    {
+        handles.push_back(queue->Enqueue<BenchmarkItem>(InplaceCallback(), ENDLESS_QUEUE_TIME));
+    }
+
+    return BenchmarkHarness::Measure(OPERATION_COUNT, [&]()
+    {
+        for (int i = 0; i < OPERATION_COUNT; i++)
+        {
+            // Cancel a different item every time, so the front, middle and back
+            // of the queue are all covered, then take its place with a new item.
+            BuildQueue::ItemHandle &handle = handles[i % queueLength];
+            queue->Cancel(handle);
+            handle = queue->Enqueue<BenchmarkItem>(InplaceCallback(), ENDLESS_QUEUE_TIME);
+
+            // Read the order back like the HUD would, fetching every button image.
+            for (BuildQueue::IQueueItem *item : *queue->GetQueueList())
+            {
+                item->GetBuildQueueButtonImage();
+            }
+        }
+    });
+}
+
+/**
+ * @brief: Measures updating a queue that holds the given number of items,
+ * without any of them finishing.
+ * 
+ * @param queueLength: The number of items in the queue.
+ * @return BenchmarkHarness::Result: The cost of a single update.
+ */
+BenchmarkHarness::Result BuildQueueBenchmark::BenchmarkUpdate(int queueLength)
+{
+    std::unique_ptr<BuildQueue> queue(CreateQueue(QUEUE_CAPACITY));
+    queue->EnqueueBatch<BenchmarkItem>(queueLength, InplaceCallback(), ENDLESS_QUEUE_TIME);
+
+    return BenchmarkHarness::Measure(OPERATION_COUNT, [&]()
+    {
+        for (int i = 0; i < OPERATION_COUNT; i++)
+        {
+            queue->Update();
+        }
+    });
+}
+
+/**
+ * @brief: Measures enqueueing an item that finishes immediately, and the
+ * update that pops it.
+ * 
+ * @return BenchmarkHarness::Result: The cost of a single enqueue and pop.
+ */
+BenchmarkHarness::Result BuildQueueBenchmark::BenchmarkPop()
+{
+    std::unique_ptr<BuildQueue> queue(CreateQueue(QUEUE_CAPACITY));
+
+    return BenchmarkHarness::Measure(OPERATION_COUNT, [&]()
+    {
+        for (int i = 0; i < OPERATION_COUNT; i++)
+        {
+            // An item with no queue time finishes on the first update.
+            queue->Enqueue<BenchmarkItem>(InplaceCallback(), 0.f);
+            queue->Update();
+        }
+    });
+}
+
+/**
+ * @brief: Measures a frame of updating the given number of full queues.
+ * 
+ * @param queueCount: The number of queues to update each frame.
+ * @param cancelChurn: Whether to cancel and re-enqueue an item in every
+ * queue each frame.
+ * @return BenchmarkHarness::Result: The cost of a single frame.
+ */
+BenchmarkHarness::Result BuildQueueBenchmark::BenchmarkFrame(int queueCount, bool cancelChurn)
+{
+    // Create all queues and fill them up.
+    std::vector<std::unique_ptr<BuildQueue>> queues;
+    std::vector<BuildQueue::ItemHandle> frontHandles;
+    for (int i = 0; i < queueCount; i++)
+    {
+        queues.emplace_back(CreateQueue(FRAME_QUEUE_CAPACITY));
+        frontHandles.push_back(queues.back()->Enqueue<BenchmarkItem>(InplaceCallback(), ENDLESS_QUEUE_TIME));
+        queues.back()->EnqueueBatch<BenchmarkItem>(FRAME_QUEUE_CAPACITY, InplaceCallback(), ENDLESS_QUEUE_TIME);
+    }
+
+    return BenchmarkHarness::Measure(FRAME_COUNT, [&]()
+    {
+        for (int frame = 0; frame < FRAME_COUNT; frame++)
+        {
+            for (int i = 0; i < queueCount; i++)
+            {
+                if (cancelChurn)
+                {
+                    // Cancel the current item and put a new one at the back.
+                    queues[i]->Cancel(frontHandles[i]);
+                    queues[i]->Enqueue<BenchmarkItem>(InplaceCallback(), ENDLESS_QUEUE_TIME);
+                    frontHandles[i] = queues[i]->GetHandle(queues[i]->GetQueueList()->front());
+                }
+
+                queues[i]->Update();
+            }
+        }
+    });
+}
+
+/**
+ * @brief: Creates a queue for benchmarking, without a HeadsUpDisplay. The
+ * benchmarks update their queues themselves, so it isn't added to the GameWorld,
+ * which would make creating and deleting thousands of queues quadratic.
+ * 
+ * @param queueCapacity: The maximum capacity of the queue.
+ * @return BuildQueue*: The created queue. Delete it when done.
+ */
+BuildQueue *BuildQueueBenchmark::CreateQueue(int queueCapacity)
+{
+    BuildQueue *queue = new BuildQueue(queueCapacity, 1, nullptr, false);
+
+    // Keep the benchmark out of the game's production telemetry.
+    queue->SetReportsTelemetry(false);
+    return queue;
+}
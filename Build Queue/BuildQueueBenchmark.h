@@ -0,0 +1,87 @@
+/**
+ * @brief: Contains the BuildQueueBenchmark class header information.
+ * @file BuildQueueBenchmark.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <irrlicht.h>
+
+#include "IUpdatable.h"
+#include "InputHandler.h"
+#include "BuildQueue.h"
+#include "BenchmarkHarness.h"
+
+/**
+ * @brief: Benchmarks the BuildQueue when F9 is pressed, and prints the results
+ * to the console. Covers the per-operation cost of Enqueue, Cancel, Update and
+ * popping finished items at every queue length, and the per-frame cost of
+ * updating large numbers of queues, with and without cancel churn.
+ *
+ * Benchmark queues are created without a HeadsUpDisplay, so only the queue itself
+ * is measured. Allocations per operation are only reported when the build
+ * defines COUNT_ALLOCATIONS.
+ */
+class BuildQueueBenchmark : public IUpdatable, public Singleton<BuildQueueBenchmark>
+{
+public:
+    /**
+     * @brief: Runs the benchmarks when F9 is pressed.
+     */
+    virtual void Update() override;
+
+    /**
+     * @brief: Runs all benchmarks and prints the results to the console.
+     */
+    void RunAll();
+
+private:
+    /**
+     * @brief: Measures enqueueing an item and cancelling another item in a queue
+     * that holds the given number of items, including the order refresh the
+     * HUD would trigger.
+     * 
+     * @param queueLength: The number of items in the queue.
+     * @return BenchmarkHarness::Result: The cost of a single enqueue and cancel.
+     */
+    BenchmarkHarness::Result BenchmarkEnqueueCancel(int queueLength);
+
+    /**
+     * @brief: Measures updating a queue that holds the given number of items,
+     * without any of them finishing.
+     * 
+     * @param queueLength: The number of items in the queue.
+     * @return BenchmarkHarness::Result: The cost of a single update.
+     */
+    BenchmarkHarness::Result BenchmarkUpdate(int queueLength);
+
+    /**
+     * @brief: Measures enqueueing an item that finishes immediately, and the
+     * update that pops it.
+     * 
+     * @return BenchmarkHarness::Result: The cost of a single enqueue and pop.
+     */
+    BenchmarkHarness::Result BenchmarkPop();
+
+    /**
+     * @brief: Measures a frame of updating the given number of full queues.
+     * 
+     * @param queueCount: The number of queues to update each frame.
+     * @param cancelChurn: Whether to cancel and re-enqueue an item in every
+     * queue each frame.
+     * @return BenchmarkHarness::Result: The cost of a single frame.
+     */
+    BenchmarkHarness::Result BenchmarkFrame(int queueCount, bool cancelChurn);
+
+    /**
+     * @brief: Creates a queue for benchmarking, without a HeadsUpDisplay. The
+     * benchmarks update their queues themselves, so it isn't added to the GameWorld,
+     * which would make creating and deleting thousands of queues quadratic.
+     * 
+     * @param queueCapacity: The maximum capacity of the queue.
+     * @return BuildQueue*: The created queue. Delete it when done.
+     */
+    BuildQueue *CreateQueue(int queueCapacity);
+};
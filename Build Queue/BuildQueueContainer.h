@@ -16,7 +16,8 @@
 class BuildQueueContainer
 {
 public:
-    BuildQueueContainer(int queueCapacity) : _buildQueue(queueCapacity)
+    BuildQueueContainer(int queueCapacity, int laneCount = 1)
+        : _buildQueue(queueCapacity, laneCount)
     {
         // Do nothing, just initialize build queue. ^
     };
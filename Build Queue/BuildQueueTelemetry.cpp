@@ -0,0 +1,138 @@
+/**
+ * @brief: Contains the BuildQueueTelemetry class function implementations.
+ * @file BuildQueueTelemetry.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "BuildQueueTelemetry.h"
+
+#include <algorithm>
+
+// Define static variables first to prevent undefined ref errors.
+std::vector<BuildQueueTelemetry::ThreadSlot *> BuildQueueTelemetry::_threadSlots;
+BuildQueueStatistics BuildQueueTelemetry::_retiredStatistics;
+std::mutex BuildQueueTelemetry::_threadSlotsMutex;
+
+/**
+ * @brief: Records that the given number of items were enqueued.
+ */
+void BuildQueueTelemetry::RecordEnqueued(int itemCount)
+{
+    Add<long long>(GetThreadSlot().itemsEnqueued, itemCount);
+}
+
+/**
+ * @brief: Records that an item finished.
+ */
+void BuildQueueTelemetry::RecordFinished()
+{
+    Add<long long>(GetThreadSlot().itemsFinished, 1);
+}
+
+/**
+ * @brief: Records that the given number of items were cancelled.
+ */
+void BuildQueueTelemetry::RecordCancelled(int itemCount)
+{
+    Add<long long>(GetThreadSlot().itemsCancelled, itemCount);
+}
+
+/**
+ * @brief: Records that a command was submitted.
+ */
+void BuildQueueTelemetry::RecordCommandSubmitted()
+{
+    Add<long long>(GetThreadSlot().commandsSubmitted, 1);
+}
+
+/**
+ * @brief: Records a BuildQueue update.
+ * 
+ * @param deltaTime: The time that passed since the previous update.
+ * @param queueDepth: The number of items in the queue.
+ */
+void BuildQueueTelemetry::RecordUpdate(float deltaTime, int queueDepth)
+{
+    ThreadSlot &slot = GetThreadSlot();
+
+    if (queueDepth > 0)
+    {
+        Add<double>(slot.busyTime, deltaTime);
+        Add<double>(slot.queueDepthTime, static_cast<double>(deltaTime) * queueDepth);
+    }
+    else
+    {
+        Add<double>(slot.idleTime, deltaTime);
+    }
+}
+
+/**
+ * @brief: Returns the counters summed over all threads.
+ * Safe to call from any thread, while other threads keep recording.
+ * 
+ * @return BuildQueueStatistics: The summed counters.
+ */
+BuildQueueStatistics BuildQueueTelemetry::GetGlobalStatistics()
+{
+    std::lock_guard<std::mutex> lock(_threadSlotsMutex);
+
+    // Sum the counters of all exited and running threads.
+    BuildQueueStatistics statistics = _retiredStatistics;
+    for (ThreadSlot *slot : _threadSlots)
+    {
+        slot->AddTo(statistics);
+    }
+
+    return statistics;
+}
+
+/**
+ * @brief: Returns the slot of the calling thread, creating it on first use.
+ */
+BuildQueueTelemetry::ThreadSlot &BuildQueueTelemetry::GetThreadSlot()
+{
+    // Constructed the first time this thread records something, and destroyed
+    // when the thread exits.
+    thread_local ThreadSlot threadSlot;
+    return threadSlot;
+}
+
+/**
+ * @brief: Adds the slot to _threadSlots.
+ */
+BuildQueueTelemetry::ThreadSlot::ThreadSlot()
+{
+    std::lock_guard<std::mutex> lock(_threadSlotsMutex);
+    _threadSlots.push_back(this);
+}
+
+/**
+ * @brief: Adds the counters to _retiredStatistics, and removes the slot
+ * from _threadSlots.
+ */
+BuildQueueTelemetry::ThreadSlot::~ThreadSlot()
+{
+    std::lock_guard<std::mutex> lock(_threadSlotsMutex);
+    AddTo(_retiredStatistics);
+
+    std::vector<ThreadSlot *>::iterator slot = std::find(_threadSlots.begin(), _threadSlots.end(), this);
+    if (slot != _threadSlots.end())
+    {
+        _threadSlots.erase(slot);
+    }
+}
+
+/**
+ * @brief: Adds the counters to the given statistics.
+ */
+void BuildQueueTelemetry::ThreadSlot::AddTo(BuildQueueStatistics &statistics) const
+{
+    statistics.itemsEnqueued += itemsEnqueued.load(std::memory_order_relaxed);
+    statistics.itemsFinished += itemsFinished.load(std::memory_order_relaxed);
+    statistics.itemsCancelled += itemsCancelled.load(std::memory_order_relaxed);
+    statistics.commandsSubmitted += commandsSubmitted.load(std::memory_order_relaxed);
+    statistics.busyTime += busyTime.load(std::memory_order_relaxed);
+    statistics.idleTime += idleTime.load(std::memory_order_relaxed);
+    statistics.queueDepthTime += queueDepthTime.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,156 @@
+/**
+ * @brief: Contains the BuildQueueTelemetry class header information.
+ * @file BuildQueueTelemetry.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief: Production counters, either for a single BuildQueue or summed over all of them.
+ */
+struct BuildQueueStatistics
+{
+    // Number of items that were enqueued, finished or cancelled.
+    long long itemsEnqueued = 0;
+    long long itemsFinished = 0;
+    long long itemsCancelled = 0;
+
+    // Number of commands submitted through SubmitEnqueue and SubmitCancel.
+    long long commandsSubmitted = 0;
+
+    // Seconds spent updating with and without items in the queue.
+    double busyTime = 0;
+    double idleTime = 0;
+
+    // Number of items in the queue, integrated over time.
+    double queueDepthTime = 0;
+
+    /**
+     * @brief: Returns the average number of items in the queue over time.
+     */
+    double GetAverageQueueDepth() const
+    {
+        double totalTime = busyTime + idleTime;
+        return totalTime > 0 ? queueDepthTime / totalTime : 0;
+    };
+};
+
+/**
+ * @brief: Keeps production counters summed over all BuildQueues.
+ * Every thread records into its own slot, so recording never contends with
+ * other threads, and the slots are only summed when the totals are requested.
+ */
+class BuildQueueTelemetry
+{
+public:
+    /**
+     * @brief: Records that the given number of items were enqueued.
+     */
+    static void RecordEnqueued(int itemCount);
+
+    /**
+     * @brief: Records that an item finished.
+     */
+    static void RecordFinished();
+
+    /**
+     * @brief: Records that the given number of items were cancelled.
+     */
+    static void RecordCancelled(int itemCount);
+
+    /**
+     * @brief: Records that a command was submitted.
+     */
+    static void RecordCommandSubmitted();
+
+    /**
+     * @brief: Records a BuildQueue update.
+     * 
+     * @param deltaTime: The time that passed since the previous update.
+     * @param queueDepth: The number of items in the queue.
+     */
+    static void RecordUpdate(float deltaTime, int queueDepth);
+
+    /**
+     * @brief: Returns the counters summed over all threads.
+     * Safe to call from any thread, while other threads keep recording.
+     * 
+     * @return BuildQueueStatistics: The summed counters.
+     */
+    static BuildQueueStatistics GetGlobalStatistics();
+
+private:
+    /**
+     * @brief: The counters of a single thread. Only the owning thread writes to
+     * them, so plain loads and stores suffice, but they are atomic so they can
+     * be read while being written. Aligned to keep slots of different threads
+     * on different cache lines.
+     *
+     * Lives in thread local storage, so it registers itself when its thread
+     * first records something, and retires itself when that thread exits.
+     */
+    struct alignas(64) ThreadSlot
+    {
+        std::atomic<long long> itemsEnqueued{0};
+        std::atomic<long long> itemsFinished{0};
+        std::atomic<long long> itemsCancelled{0};
+        std::atomic<long long> commandsSubmitted{0};
+        std::atomic<double> busyTime{0};
+        std::atomic<double> idleTime{0};
+        std::atomic<double> queueDepthTime{0};
+
+        /**
+         * @brief: Adds the slot to _threadSlots.
+         */
+        ThreadSlot();
+
+        /**
+         * @brief: Adds the counters to _retiredStatistics, and removes the slot
+         * from _threadSlots.
+         */
+        ~ThreadSlot();
+
+        /**
+         * @brief: Adds the counters to the given statistics.
+         */
+        void AddTo(BuildQueueStatistics &statistics) const;
+    };
+
+    /**
+     * @brief: Returns the slot of the calling thread, creating it on first use.
+     */
+    static ThreadSlot &GetThreadSlot();
+
+    /**
+     * @brief: Adds the given amount to a counter owned by the calling thread.
+     */
+    template <typename T>
+    static void Add(std::atomic<T> &counter, T amount)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief: The slots of all running threads that recorded anything.
+     */
+    static std::vector<ThreadSlot *> _threadSlots;
+
+    /**
+     * @brief: The counters of all threads that exited, so their counts are kept
+     * after their slots are gone.
+     */
+    static BuildQueueStatistics _retiredStatistics;
+
+    /**
+     * @brief: Guards _threadSlots and _retiredStatistics. Only taken when a
+     * thread records for the first time or exits, and when the totals are requested.
+     */
+    static std::mutex _threadSlotsMutex;
+};
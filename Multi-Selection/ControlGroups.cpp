@@ -0,0 +1,144 @@
+/**
+ * @brief: Contains the ControlGroups class function implementations.
+ * @file ControlGroups.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "ControlGroups.h"
+
+#include <cstdio>
+
+/**
+ * @brief Replaces the contents of the given group with the given objects.
+ * 
+ * @param group The number of the group.
+ * @param objects The objects to store in the group.
+ */
+void ControlGroups::Store(int group, const std::vector<LevelObject *> &objects)
+{
+    if (!IsValidGroup(group))
+    {
+        return;
+    }
+
+    _groups[group].Clear();
+    Add(group, objects);
+}
+
+/**
+ * @brief Adds the given objects that aren't in the given group yet to it,
+ * keeping its current contents.
+ * 
+ * @param group The number of the group.
+ * @param objects The objects to add to the group.
+ */
+void ControlGroups::Add(int group, const std::vector<LevelObject *> &objects)
+{
+    if (!IsValidGroup(group))
+    {
+        return;
+    }
+
+    LevelObjectTypeRegistry *registry = LevelObjectTypeRegistry::GetInstance();
+    SelectionSet &groupObjects = _groups[group];
+    groupObjects.Reserve(groupObjects.GetCount() + objects.size());
+
+    for (LevelObject *object : objects)
+    {
+        // Only store live objects, so a destroyed one can't come back later.
+        if (registry->IsRegistered(object))
+        {
+            groupObjects.Add(object);
+        }
+    }
+}
+
+/**
+ * @brief Replaces the given selection with the objects in the given group
+ * that still exist, in a single batch.
+ * 
+ * @param group The number of the group.
+ * @param selection The selection to restore the group into.
+ */
+void ControlGroups::Recall(int group, SelectionSet &selection)
+{
+    if (!IsValidGroup(group))
+    {
+        return;
+    }
+
+    Prune(group);
+    const std::vector<LevelObject *> &objects = _groups[group].GetObjects();
+
+    // Replace the selection in one go.
+    selection.Clear();
+    selection.Reserve(objects.size());
+    selection.AddRange(objects.begin(), objects.end());
+}
+
+/**
+ * @brief Returns the number of objects in the given group that still exist.
+ * 
+ * @param group The number of the group.
+ * @return int The number of objects in the group.
+ */
+int ControlGroups::GetObjectCount(int group)
+{
+    if (!IsValidGroup(group))
+    {
+        return 0;
+    }
+
+    Prune(group);
+    return static_cast<int>(_groups[group].GetCount());
+}
+
+/**
+ * @brief Removes all objects from the given group.
+ * 
+ * @param group The number of the group.
+ */
+void ControlGroups::Clear(int group)
+{
+    if (IsValidGroup(group))
+    {
+        _groups[group].Clear();
+    }
+}
+
+/**
+ * @brief Returns whether the given group number exists, and reports it if it doesn't.
+ */
+bool ControlGroups::IsValidGroup(int group)
+{
+    if (group < 0 || group >= GROUP_COUNT)
+    {
+        printf("Tried to use control group %d, which doesn't exist.\n", group);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Removes objects that no longer exist from the given group.
+ */
+void ControlGroups::Prune(int group)
+{
+    LevelObjectTypeRegistry *registry = LevelObjectTypeRegistry::GetInstance();
+    SelectionSet &groupObjects = _groups[group];
+
+    // Collect the destroyed objects first, since removing them can compact the
+    // list that's being read.
+    _destroyedObjects.clear();
+    for (LevelObject *object : groupObjects.GetObjects())
+    {
+        if (!registry->IsRegistered(object))
+        {
+            _destroyedObjects.push_back(object);
+        }
+    }
+
+    groupObjects.SubtractRange(_destroyedObjects.begin(), _destroyedObjects.end());
+}
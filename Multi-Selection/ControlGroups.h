@@ -0,0 +1,90 @@
+/**
+ * @brief: Contains the ControlGroups class header information.
+ * @file ControlGroups.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <Singleton.h>
+#include <LevelObject.h>
+
+#include "LevelObjectTypeRegistry.h"
+#include "SelectionSet.h"
+
+/**
+ * @brief: Numbered control groups that store a selection and restore it later.
+ * Every object is stored once per group, no matter how often it's added.
+ * Objects that were destroyed are detected through the LevelObjectTypeRegistry,
+ * and pruned from the group the next time it is used. Objects keep their place
+ * in a group while they move, and while they're off the grid.
+ */
+class ControlGroups : public Singleton<ControlGroups>
+{
+public:
+    /**
+     * @brief The number of control groups, numbered from 0.
+     */
+    static const int GROUP_COUNT = 10;
+
+    /**
+     * @brief Replaces the contents of the given group with the given objects.
+     * 
+     * @param group The number of the group.
+     * @param objects The objects to store in the group.
+     */
+    void Store(int group, const std::vector<LevelObject *> &objects);
+
+    /**
+     * @brief Adds the given objects that aren't in the given group yet to it,
+     * keeping its current contents.
+     * 
+     * @param group The number of the group.
+     * @param objects The objects to add to the group.
+     */
+    void Add(int group, const std::vector<LevelObject *> &objects);
+
+    /**
+     * @brief Replaces the given selection with the objects in the given group
+     * that still exist, in a single batch.
+     * 
+     * @param group The number of the group.
+     * @param selection The selection to restore the group into.
+     */
+    void Recall(int group, SelectionSet &selection);
+
+    /**
+     * @brief Returns the number of objects in the given group that still exist.
+     * 
+     * @param group The number of the group.
+     * @return int The number of objects in the group.
+     */
+    int GetObjectCount(int group);
+
+    /**
+     * @brief Removes all objects from the given group.
+     * 
+     * @param group The number of the group.
+     */
+    void Clear(int group);
+
+private:
+    /**
+     * @brief Returns whether the given group number exists, and reports it if it doesn't.
+     */
+    bool IsValidGroup(int group);
+
+    /**
+     * @brief Removes objects that no longer exist from the given group.
+     */
+    void Prune(int group);
+
+    // The objects in every group, in the order they were stored.
+    SelectionSet _groups[GROUP_COUNT];
+
+    // Reused to collect the destroyed objects of a group while pruning it.
+    std::vector<LevelObject *> _destroyedObjects;
+};
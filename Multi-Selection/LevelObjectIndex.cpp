@@ -0,0 +1,376 @@
+/**
+ * @brief: Contains the LevelObjectIndex class function implementations.
+ * @file LevelObjectIndex.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "LevelObjectIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <ThreadPool.h>
+
+/**
+ * @brief Clears the index and sizes it for a grid of the given dimensions.
+ * 
+ * @param gridDimensions The number of grid nodes in the X and Y direction.
+ */
+void LevelObjectIndex::Initialize(dimension2du gridDimensions)
+{
+    _gridDimensions = gridDimensions;
+
+    // Round up, so the last partial bucket in each direction is included.
+    _bucketColumns = (gridDimensions.Width + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    _bucketRows = (gridDimensions.Height + BUCKET_SIZE - 1) / BUCKET_SIZE;
+
+    _buckets.clear();
+    _buckets.resize(_bucketColumns * _bucketRows);
+
+    _occupancy.Initialize(gridDimensions.Width, gridDimensions.Height);
+
+    _objectIds.clear();
+    _objectRecords.clear();
+    _freeObjectIds.clear();
+    _visitStamp = 0;
+    _populated = false;
+    _version++;
+}
+
+/**
+ * @brief Registers the given object as occupying the node at the given coordinate.
+ * 
+ * @param object The object that was placed.
+ * @param coordinate The coordinate of the node the object was placed on.
+ * @param mask The category and owner bits of the object.
+ */
+void LevelObjectIndex::OnLevelObjectPlaced(LevelObject *object, vector2di coordinate, ObjectMask mask)
+{
+    // Make sure the coordinate is actually on the grid.
+    if (!IsInGrid(coordinate))
+    {
+        printf("Tried to index a LevelObject outside of the grid at (%d, %d).\n",
+               coordinate.X, coordinate.Y);
+        return;
+    }
+
+    // From now on, the index is kept up to date by whoever places objects.
+    _populated = true;
+    _version++;
+
+    // Look up the id of the object, or give it one if this is its first node.
+    auto objectId = _objectIds.find(object);
+    if (objectId == _objectIds.end())
+    {
+        int newId;
+        if (_freeObjectIds.empty())
+        {
+            newId = static_cast<int>(_objectRecords.size());
+            _objectRecords.push_back(ObjectRecord());
+        }
+        else
+        {
+            newId = _freeObjectIds.back();
+            _freeObjectIds.pop_back();
+        }
+
+        ObjectRecord &record = _objectRecords[newId];
+        record.object = object;
+        record.minimumCoordinate = coordinate;
+        record.maximumCoordinate = coordinate;
+        objectId = _objectIds.emplace(object, newId).first;
+    }
+
+    // Grow the bounds of the object to include the new node.
+    ObjectRecord &record = _objectRecords[objectId->second];
+    record.nodeCount++;
+    record.mask = mask;
+    record.minimumCoordinate.X = std::min(record.minimumCoordinate.X, coordinate.X);
+    record.minimumCoordinate.Y = std::min(record.minimumCoordinate.Y, coordinate.Y);
+    record.maximumCoordinate.X = std::max(record.maximumCoordinate.X, coordinate.X);
+    record.maximumCoordinate.Y = std::max(record.maximumCoordinate.Y, coordinate.Y);
+
+    GetBucket(coordinate).push_back({coordinate, object, objectId->second, mask});
+    _occupancy.Set(coordinate.X, coordinate.Y);
+}
+
+/**
+ * @brief Changes the category and owner bits of the given object, such as
+ * when it changes owner. Only visits the buckets the object was placed in.
+ * 
+ * @param object The object to change the bits of.
+ * @param mask The new category and owner bits of the object.
+ */
+void LevelObjectIndex::SetObjectMask(LevelObject *object, ObjectMask mask)
+{
+    auto objectId = _objectIds.find(object);
+    if (objectId == _objectIds.end())
+    {
+        return;
+    }
+
+    ObjectRecord &record = _objectRecords[objectId->second];
+    record.mask = mask;
+
+    // Update the copies of the mask in all entries of the object.
+    for (int bucketY = record.minimumCoordinate.Y / BUCKET_SIZE; bucketY <= record.maximumCoordinate.Y / BUCKET_SIZE; bucketY++)
+    {
+        for (int bucketX = record.minimumCoordinate.X / BUCKET_SIZE; bucketX <= record.maximumCoordinate.X / BUCKET_SIZE; bucketX++)
+        {
+            for (Entry &entry : _buckets[bucketY * _bucketColumns + bucketX])
+            {
+                if (entry.objectId == objectId->second)
+                {
+                    entry.mask = mask;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sets the function that derives the category and owner bits of
+ * objects that aren't indexed. The game sets this, since only it knows
+ * which objects are units or buildings and who owns them.
+ * 
+ * @param maskFunction The function to derive masks with, or null for none.
+ */
+void LevelObjectIndex::SetMaskFunction(MaskFunction maskFunction)
+{
+    _maskFunction = maskFunction;
+}
+
+/**
+ * @brief Returns the category and owner bits of the given object. Uses the
+ * copy the index holds if the object is indexed, and the mask function
+ * otherwise.
+ * 
+ * @param object The object to get the bits of.
+ * @return ObjectMask The bits of the object, 0 if they aren't known.
+ */
+LevelObjectIndex::ObjectMask LevelObjectIndex::GetObjectMask(LevelObject *object)
+{
+    auto objectId = _objectIds.find(object);
+    if (objectId != _objectIds.end())
+    {
+        return _objectRecords[objectId->second].mask;
+    }
+
+    return _maskFunction ? _maskFunction(object) : 0;
+}
+
+/**
+ * @brief Unregisters the given object from the node at the given coordinate.
+ * 
+ * @param object The object that was removed.
+ * @param coordinate The coordinate of the node the object was removed from.
+ */
+void LevelObjectIndex::OnLevelObjectRemoved(LevelObject *object, vector2di coordinate)
+{
+    if (!IsInGrid(coordinate))
+    {
+        return;
+    }
+
+    std::vector<Entry> &bucket = GetBucket(coordinate);
+
+    // Find the entry in the bucket. A bucket holds at most BUCKET_SIZE squared
+    // entries, so this is a short scan.
+    for (std::size_t i = 0; i < bucket.size(); i++)
+    {
+        if (bucket[i].object == object && bucket[i].coordinate == coordinate)
+        {
+            int objectId = bucket[i].objectId;
+            _version++;
+
+            // Order within a bucket doesn't matter, so swap with the last entry
+            // and pop instead of shifting the entries behind it.
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+
+            // Only mark the node as empty if no other object is left on it.
+            bool nodeOccupied = false;
+            for (const Entry &entry : bucket)
+            {
+                if (entry.coordinate == coordinate)
+                {
+                    nodeOccupied = true;
+                    break;
+                }
+            }
+            if (!nodeOccupied)
+            {
+                _occupancy.Clear(coordinate.X, coordinate.Y);
+            }
+
+            // Free the id of the object once its last node is removed.
+            ObjectRecord &record = _objectRecords[objectId];
+            if (--record.nodeCount == 0)
+            {
+                _objectIds.erase(object);
+                _freeObjectIds.push_back(objectId);
+                record.object = nullptr;
+                record.generation++;
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Stores all occupied nodes in the given area in the given list.
+ * The area is clamped to the grid.
+ * 
+ * @param bottomLeft The coordinate of the bottom left node of the area.
+ * @param topRight The coordinate of the top right node of the area, inclusive.
+ * @param entries The list to add all found nodes to. Not cleared first.
+ */
+void LevelObjectIndex::GetEntriesInArea(vector2di bottomLeft, vector2di topRight,
+                                        std::vector<Entry> &entries)
+{
+    VisitEntriesInArea(bottomLeft, topRight, [&entries](const Entry &entry)
+    {
+        entries.push_back(entry);
+    });
+}
+
+/**
+ * @brief Returns a handle to the given object.
+ * 
+ * @param object The object to get a handle to.
+ * @return ObjectHandle A handle to the object. Empty if the object isn't on the grid.
+ */
+LevelObjectIndex::ObjectHandle LevelObjectIndex::GetHandle(LevelObject *object)
+{
+    ObjectHandle handle;
+
+    auto objectId = _objectIds.find(object);
+    if (objectId != _objectIds.end())
+    {
+        handle.objectId = objectId->second;
+        handle.generation = _objectRecords[objectId->second].generation;
+    }
+
+    return handle;
+}
+
+/**
+ * @brief Returns the object the given handle refers to.
+ * 
+ * @param handle The handle of the object.
+ * @return LevelObject* The object, or nullptr if it was removed from the grid.
+ */
+LevelObject *LevelObjectIndex::GetObject(ObjectHandle handle)
+{
+    // Make sure the handle refers to an id that still belongs to the same object.
+    if (handle.objectId < 0 || handle.objectId >= static_cast<int>(_objectRecords.size()) ||
+        _objectRecords[handle.objectId].generation != handle.generation)
+    {
+        return nullptr;
+    }
+
+    return _objectRecords[handle.objectId].object;
+}
+
+/**
+ * @brief Returns a stamp no object record holds yet, for a new query.
+ */
+unsigned int LevelObjectIndex::BeginVisit()
+{
+    // Once every 4 billion queries the stamp wraps around. Clear all stamps
+    // then, so stamps from before the wrap can't be mistaken for new ones.
+    if (++_visitStamp == 0)
+    {
+        for (ObjectRecord &record : _objectRecords)
+        {
+            record.visitStamp = 0;
+        }
+        _visitStamp = 1;
+    }
+
+    return _visitStamp;
+}
+
+/**
+ * @brief Returns whether the given coordinate lies within the grid.
+ */
+bool LevelObjectIndex::IsInGrid(vector2di coordinate)
+{
+    return coordinate.X >= 0 && coordinate.X < static_cast<int>(_gridDimensions.Width) &&
+           coordinate.Y >= 0 && coordinate.Y < static_cast<int>(_gridDimensions.Height);
+}
+
+/**
+ * @brief Returns whether the given area is large enough to be worth
+ * scanning on the thread pool.
+ */
+bool LevelObjectIndex::ShouldQueryInParallel(vector2di bottomLeft, vector2di topRight)
+{
+    if (ThreadPool::GetInstance()->GetWorkerCount() == 0)
+    {
+        return false;
+    }
+
+    // Only count the part of the area that lies within the grid.
+    long long width = std::min(topRight.X, static_cast<int>(_gridDimensions.Width) - 1) -
+                      std::max(bottomLeft.X, 0) + 1;
+    long long height = std::min(topRight.Y, static_cast<int>(_gridDimensions.Height) - 1) -
+                       std::max(bottomLeft.Y, 0) + 1;
+
+    return width > 0 && height > 0 && width * height >= PARALLEL_QUERY_MINIMUM_NODES;
+}
+
+/**
+ * @brief Splits the given area into bands of node rows, and gathers the
+ * entries in each band whose mask passes the given filter on the thread pool.
+ * 
+ * @return int The number of bands, whose entries are in _bandEntries, in
+ * the same order a serial query would visit them.
+ */
+int LevelObjectIndex::GatherEntriesInBands(vector2di bottomLeft, vector2di topRight,
+                                           MaskFilter maskFilter)
+{
+    bottomLeft.Y = std::max(bottomLeft.Y, 0);
+    topRight.Y = std::min(topRight.Y, static_cast<int>(_gridDimensions.Height) - 1);
+
+    // A band is one row of occupancy regions. Serial queries visit the regions
+    // row by row, so visiting the bands in order gives the exact same order.
+    const int bandHeight = OccupancyBitmap::REGION_SIZE;
+    int firstBand = bottomLeft.Y / bandHeight;
+    int bandCount = topRight.Y / bandHeight - firstBand + 1;
+
+    if (static_cast<int>(_bandEntries.size()) < bandCount)
+    {
+        _bandEntries.resize(bandCount);
+    }
+
+    // Every band only reads the index, and only writes to its own list.
+    auto gatherBand = [&](int band)
+    {
+        std::vector<const Entry *> &entries = _bandEntries[band];
+        entries.clear();
+
+        vector2di bandBottomLeft(bottomLeft.X, std::max(bottomLeft.Y, (firstBand + band) * bandHeight));
+        vector2di bandTopRight(topRight.X, std::min(topRight.Y, (firstBand + band + 1) * bandHeight - 1));
+
+        VisitEntriesInArea(bandBottomLeft, bandTopRight, [&](const Entry &entry)
+        {
+            if (maskFilter.Passes(entry.mask))
+            {
+                entries.push_back(&entry);
+            }
+        });
+    };
+    ThreadPool::GetInstance()->ParallelFor(bandCount, gatherBand);
+
+    return bandCount;
+}
+
+/**
+ * @brief Returns the bucket the node at the given coordinate is kept in.
+ */
+std::vector<LevelObjectIndex::Entry> &LevelObjectIndex::GetBucket(vector2di coordinate)
+{
+    return _buckets[(coordinate.Y / BUCKET_SIZE) * _bucketColumns + coordinate.X / BUCKET_SIZE];
+}
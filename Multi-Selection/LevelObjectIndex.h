@@ -0,0 +1,478 @@
+/**
+ * @brief: Contains the LevelObjectIndex class header information.
+ * @file LevelObjectIndex.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include <irrlicht.h>
+
+#include <Singleton.h>
+#include <LevelObject.h>
+#include <OccupancyBitmap.h>
+
+using irr::core::dimension2du;
+using irr::core::vector2di;
+
+// The minimum number of grid nodes in an area before object queries over it are
+// split over the thread pool. Smaller areas are quicker to query serially than
+// it takes to wake up the worker threads.
+#define PARALLEL_QUERY_MINIMUM_NODES (256 * 256)
+
+/**
+ * @brief: Spatial index of the grid nodes that hold a LevelObject.
+ * Occupied nodes are kept in buckets of BUCKET_SIZE x BUCKET_SIZE nodes, so an
+ * area query only visits the buckets overlapping the area and the occupied
+ * nodes inside them, instead of every node in the area.
+ *
+ * The Grid keeps the index up to date by calling OnLevelObjectPlaced and
+ * OnLevelObjectRemoved for every node a LevelObject is placed on or removed from.
+ * Until the first object is placed, IsPopulated returns false, and MultiSelector
+ * scans the Grid nodes instead.
+ *
+ * Every indexed object gets a dense id with a record, holding the stamp of the
+ * last query that visited it. Object queries bump the stamp once per query, so
+ * objects covering multiple nodes are returned once, without clearing anything.
+ *
+ * Every entry also carries a copy of its object's mask of category and owner
+ * bits, so common filters are plain bit tests over the bucket data. Objects that
+ * aren't indexed get their mask from the mask function the game sets with
+ * SetMaskFunction, which is how the Grid scan in MultiSelector filters objects.
+ *
+ * Alongside the buckets, an occupancy bitmap marks every occupied node, and
+ * every non-empty bucket in a coarser summary level. Area queries use the
+ * summary to skip empty buckets, and empty 64 x 64 node regions, in one go.
+ *
+ * Object queries over large areas gather their entries in bands of node rows
+ * on the thread pool, then visit the objects serially in band order, so the
+ * visitor is never called concurrently and sees the same order as a serial query.
+ */
+class LevelObjectIndex : public Singleton<LevelObjectIndex>
+{
+public:
+    /**
+     * @brief The width and height of a bucket, in grid nodes.
+     */
+    static const int BUCKET_SIZE = 8;
+
+    static_assert(BUCKET_SIZE == OccupancyBitmap::BLOCK_SIZE,
+                  "Buckets must line up with the blocks of the occupancy bitmap.");
+
+    /**
+     * @brief Category and owner bits of an object. The low bits hold the
+     * category, the bits from OWNER_SHIFT upwards hold one bit per player.
+     */
+    typedef unsigned int ObjectMask;
+
+    // Object categories.
+    static const ObjectMask UNIT_CATEGORY = 1 << 0;
+    static const ObjectMask BUILDING_CATEGORY = 1 << 1;
+    static const ObjectMask NATURE_CATEGORY = 1 << 2;
+
+    // The first bit of the owner bits.
+    static const int OWNER_SHIFT = 16;
+
+    /**
+     * @brief Returns the owner bit of the given player.
+     */
+    static ObjectMask GetOwnerBit(int player)
+    {
+        return 1u << (OWNER_SHIFT + player);
+    }
+
+    /**
+     * @brief Returns the category and owner bits of the given object.
+     */
+    typedef ObjectMask (*MaskFunction)(LevelObject *object);
+
+    /**
+     * @brief Selects objects by their mask. An object passes if it has all
+     * bits of allOf, and at least one bit of anyOf, unless anyOf is 0.
+     * For example, own units only: allOf = UNIT_CATEGORY | GetOwnerBit(player).
+     */
+    struct MaskFilter
+    {
+        ObjectMask allOf = 0;
+        ObjectMask anyOf = 0;
+
+        bool Passes(ObjectMask mask) const
+        {
+            return (mask & allOf) == allOf && (anyOf == 0 || (mask & anyOf) != 0);
+        }
+
+        bool IsEmpty() const
+        {
+            return allOf == 0 && anyOf == 0;
+        }
+    };
+
+    /**
+     * @brief An occupied grid node.
+     */
+    struct Entry
+    {
+        vector2di coordinate;
+        LevelObject *object;
+        int objectId;
+        ObjectMask mask;
+    };
+
+    /**
+     * @brief A compact reference to an indexed object, that can tell whether
+     * the object has been removed from the grid since the handle was made.
+     */
+    struct ObjectHandle
+    {
+        int objectId = -1;
+        unsigned int generation = 0;
+    };
+
+    /**
+     * @brief Clears the index and sizes it for a grid of the given dimensions.
+     * 
+     * @param gridDimensions The number of grid nodes in the X and Y direction.
+     */
+    void Initialize(dimension2du gridDimensions);
+
+    /**
+     * @brief Registers the given object as occupying the node at the given coordinate.
+     * 
+     * @param object The object that was placed.
+     * @param coordinate The coordinate of the node the object was placed on.
+     * @param mask The category and owner bits of the object.
+     */
+    void OnLevelObjectPlaced(LevelObject *object, vector2di coordinate, ObjectMask mask = 0);
+
+    /**
+     * @brief Changes the category and owner bits of the given object, such as
+     * when it changes owner. Only visits the buckets the object was placed in.
+     * 
+     * @param object The object to change the bits of.
+     * @param mask The new category and owner bits of the object.
+     */
+    void SetObjectMask(LevelObject *object, ObjectMask mask);
+
+    /**
+     * @brief Sets the function that derives the category and owner bits of
+     * objects that aren't indexed. The game sets this, since only it knows
+     * which objects are units or buildings and who owns them.
+     * 
+     * @param maskFunction The function to derive masks with, or null for none.
+     */
+    void SetMaskFunction(MaskFunction maskFunction);
+
+    /**
+     * @brief Returns whether masks can be derived for objects that aren't indexed.
+     */
+    bool HasMaskFunction() const
+    {
+        return _maskFunction != nullptr;
+    }
+
+    /**
+     * @brief Returns the category and owner bits of the given object. Uses the
+     * copy the index holds if the object is indexed, and the mask function
+     * otherwise.
+     * 
+     * @param object The object to get the bits of.
+     * @return ObjectMask The bits of the object, 0 if they aren't known.
+     */
+    ObjectMask GetObjectMask(LevelObject *object);
+
+    /**
+     * @brief Unregisters the given object from the node at the given coordinate.
+     * 
+     * @param object The object that was removed.
+     * @param coordinate The coordinate of the node the object was removed from.
+     */
+    void OnLevelObjectRemoved(LevelObject *object, vector2di coordinate);
+
+    /**
+     * @brief Stores all occupied nodes in the given area in the given list.
+     * The area is clamped to the grid.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param entries The list to add all found nodes to. Not cleared first.
+     */
+    void GetEntriesInArea(vector2di bottomLeft, vector2di topRight,
+                          std::vector<Entry> &entries);
+
+    /**
+     * @brief Returns a handle to the given object.
+     * 
+     * @param object The object to get a handle to.
+     * @return ObjectHandle A handle to the object. Empty if the object isn't on the grid.
+     */
+    ObjectHandle GetHandle(LevelObject *object);
+
+    /**
+     * @brief Returns the object the given handle refers to.
+     * 
+     * @param handle The handle of the object.
+     * @return LevelObject* The object, or nullptr if it was removed from the grid.
+     */
+    LevelObject *GetObject(ObjectHandle handle);
+
+    /**
+     * @brief Returns whether any object was placed since the index was last
+     * initialized, which tells that the placement code keeps it up to date.
+     * Until then, the index is empty, and callers should scan the Grid instead.
+     */
+    bool IsPopulated() const
+    {
+        return _populated;
+    }
+
+    /**
+     * @brief Returns a number that changes whenever an object is placed or
+     * removed. Compare it to a previously returned number to tell whether
+     * anything that depends on the objects in an area needs updating.
+     */
+    unsigned int GetVersion() const
+    {
+        return _version;
+    }
+
+    /**
+     * @brief Calls the given visitor for every occupied node in the given area.
+     * The area is clamped to the grid. Never allocates, and the visitor is
+     * inlined, so this is cheap enough to run many times per frame.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param visitor Called with a const Entry & for every occupied node.
+     */
+    template <typename Visitor>
+    void VisitEntriesInArea(vector2di bottomLeft, vector2di topRight, Visitor &&visitor)
+    {
+        // Clamp the area to the grid.
+        bottomLeft.X = std::max(bottomLeft.X, 0);
+        bottomLeft.Y = std::max(bottomLeft.Y, 0);
+        topRight.X = std::min(topRight.X, static_cast<int>(_gridDimensions.Width) - 1);
+        topRight.Y = std::min(topRight.Y, static_cast<int>(_gridDimensions.Height) - 1);
+
+        // Return if the area lies entirely outside of the grid.
+        if (bottomLeft.X > topRight.X || bottomLeft.Y > topRight.Y)
+        {
+            return;
+        }
+
+        // Loop over the non-empty buckets that overlap the area. Empty ones are
+        // skipped by the occupancy bitmap without being looked at.
+        _occupancy.VisitOccupiedBlocksInArea(bottomLeft.X, bottomLeft.Y, topRight.X, topRight.Y,
+                                             [&](int bucketX, int bucketY)
+        {
+            // Only the buckets on the edge of the area can hold nodes outside of it,
+            // but checking every entry is cheaper than telling those apart.
+            for (const Entry &entry : _buckets[bucketY * _bucketColumns + bucketX])
+            {
+                if (entry.coordinate.X >= bottomLeft.X && entry.coordinate.X <= topRight.X &&
+                    entry.coordinate.Y >= bottomLeft.Y && entry.coordinate.Y <= topRight.Y)
+                {
+                    visitor(entry);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Calls the given visitor once for every object with at least one
+     * occupied node in the given area, no matter how many nodes it covers.
+     * Must not be called again from within the visitor.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param visitor Called with a LevelObject * for every object.
+     */
+    template <typename Visitor>
+    void VisitObjectsInArea(vector2di bottomLeft, vector2di topRight, Visitor &&visitor)
+    {
+        VisitObjectsInArea(bottomLeft, topRight, MaskFilter(), std::forward<Visitor>(visitor));
+    }
+
+    /**
+     * @brief Calls the given visitor once for every object in the given area
+     * whose mask passes the given filter. The mask is tested on the entry
+     * itself, before the object record is even looked at.
+     * Areas of at least PARALLEL_QUERY_MINIMUM_NODES nodes gather their entries
+     * on the thread pool, one band of rows per iteration. Only that gathering
+     * is parallel: removing duplicate objects and calling the visitor still
+     * happen serially on the calling thread, so they cost the same either way.
+     * Must not be called again from within the visitor.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param maskFilter The filter object masks must pass.
+     * @param visitor Called with a LevelObject * for every object.
+     */
+    template <typename Visitor>
+    void VisitObjectsInArea(vector2di bottomLeft, vector2di topRight,
+                            MaskFilter maskFilter, Visitor &&visitor)
+    {
+        unsigned int visitStamp = BeginVisit();
+
+        auto visitEntry = [&](const Entry &entry)
+        {
+            // Skip objects that were already visited through another node.
+            ObjectRecord &record = _objectRecords[entry.objectId];
+            if (record.visitStamp != visitStamp)
+            {
+                record.visitStamp = visitStamp;
+                visitor(entry.object);
+            }
+        };
+
+        if (!ShouldQueryInParallel(bottomLeft, topRight))
+        {
+            VisitEntriesInArea(bottomLeft, topRight, [&](const Entry &entry)
+            {
+                if (maskFilter.Passes(entry.mask))
+                {
+                    visitEntry(entry);
+                }
+            });
+            return;
+        }
+
+        // Deduplicate the gathered entries serially, band after band.
+        int bandCount = GatherEntriesInBands(bottomLeft, topRight, maskFilter);
+        for (int band = 0; band < bandCount; band++)
+        {
+            for (const Entry *entry : _bandEntries[band])
+            {
+                visitEntry(*entry);
+            }
+        }
+    }
+
+    /**
+     * @brief Writes every object in the given area that passes the given filter
+     * to the given output iterator, once per object. Areas smaller than
+     * PARALLEL_QUERY_MINIMUM_NODES never allocate by themselves, so with an
+     * iterator into caller-owned storage, the whole query is allocation free.
+     * Larger areas gather their entries in parallel into per-band buffers owned
+     * by the index, which only allocate until they have grown to fit the largest
+     * query so far. The filter and the writes still run serially on the calling
+     * thread, after removing duplicate objects.
+     * The filter must not query the index again.
+     * 
+     * Usage: a fixed array with a plain pointer as the iterator, or a reserved
+     * vector with std::back_inserter.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param filter Called with a LevelObject *. Only objects it returns true for are written.
+     * @param output The iterator to write the found objects to.
+     * @return OutputIterator The iterator past the last written object.
+     */
+    template <typename Filter, typename OutputIterator>
+    OutputIterator GetObjectsInArea(vector2di bottomLeft, vector2di topRight,
+                                    Filter &&filter, OutputIterator output)
+    {
+        VisitObjectsInArea(bottomLeft, topRight, [&](LevelObject *object)
+        {
+            if (filter(object))
+            {
+                *output++ = object;
+            }
+        });
+
+        return output;
+    }
+
+private:
+    /**
+     * @brief Everything the index keeps track of per object.
+     */
+    struct ObjectRecord
+    {
+        LevelObject *object = nullptr;
+        // The number of nodes the object occupies.
+        int nodeCount = 0;
+        // The stamp of the last query that visited the object.
+        unsigned int visitStamp = 0;
+        // Incremented whenever the id is freed, to invalidate handles to it.
+        unsigned int generation = 0;
+        // The category and owner bits of the object.
+        ObjectMask mask = 0;
+        // The bounds of all nodes the object was placed on, both inclusive.
+        vector2di minimumCoordinate;
+        vector2di maximumCoordinate;
+    };
+
+    /**
+     * @brief Returns a stamp no object record holds yet, for a new query.
+     */
+    unsigned int BeginVisit();
+
+    /**
+     * @brief Returns whether the given coordinate lies within the grid.
+     */
+    bool IsInGrid(vector2di coordinate);
+
+    /**
+     * @brief Returns whether the given area is large enough to be worth
+     * scanning on the thread pool.
+     */
+    bool ShouldQueryInParallel(vector2di bottomLeft, vector2di topRight);
+
+    /**
+     * @brief Splits the given area into bands of node rows, and gathers the
+     * entries in each band whose mask passes the given filter on the thread pool.
+     * 
+     * @return int The number of bands, whose entries are in _bandEntries, in
+     * the same order a serial query would visit them.
+     */
+    int GatherEntriesInBands(vector2di bottomLeft, vector2di topRight, MaskFilter maskFilter);
+
+    /**
+     * @brief Returns the bucket the node at the given coordinate is kept in.
+     */
+    std::vector<Entry> &GetBucket(vector2di coordinate);
+
+    // The number of grid nodes in the X and Y direction.
+    dimension2du _gridDimensions = dimension2du(0, 0);
+
+    // The number of buckets in the X and Y direction.
+    int _bucketColumns = 0;
+    int _bucketRows = 0;
+
+    // The occupied nodes of every bucket, row by row.
+    std::vector<std::vector<Entry>> _buckets;
+
+    // Which nodes and buckets are occupied.
+    OccupancyBitmap _occupancy;
+
+    // The id of every indexed object.
+    std::unordered_map<LevelObject *, int> _objectIds;
+
+    // The record of every object, by id.
+    std::vector<ObjectRecord> _objectRecords;
+
+    // The ids of removed objects, to hand out again.
+    std::vector<int> _freeObjectIds;
+
+    // The stamp of the last query.
+    unsigned int _visitStamp = 0;
+
+    // Whether any object was placed since the last Initialize.
+    bool _populated = false;
+
+    // Incremented whenever an object is placed or removed.
+    unsigned int _version = 0;
+
+    // Derives the masks of objects that aren't indexed, null if not set.
+    MaskFunction _maskFunction = nullptr;
+
+    // The entries gathered per band by the last parallel query. Kept around so
+    // their storage is reused by the next one.
+    std::vector<std::vector<const Entry *>> _bandEntries;
+};
@@ -0,0 +1,107 @@
+/**
+ * @brief: Contains the LevelObjectTypeRegistry class function implementations.
+ * @file LevelObjectTypeRegistry.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "LevelObjectTypeRegistry.h"
+
+/**
+ * @brief Registers the given object under the given type.
+ * 
+ * @param object The object to register.
+ * @param typeId The type of the object.
+ * @param position The position of the object.
+ */
+void LevelObjectTypeRegistry::Register(LevelObject *object, unsigned short typeId, vector3df position)
+{
+    // Registering twice would leave a stale copy behind, so move it instead.
+    Unregister(object);
+
+    if (typeId >= _types.size())
+    {
+        _types.resize(typeId + 1);
+    }
+
+    TypeObjects &type = _types[typeId];
+    _locations[object] = {typeId, static_cast<int>(type.objects.size())};
+
+    type.x.push_back(position.X);
+    type.z.push_back(position.Z);
+    type.objects.push_back(object);
+}
+
+/**
+ * @brief Unregisters the given object, if it was registered.
+ * 
+ * @param object The object to unregister.
+ */
+void LevelObjectTypeRegistry::Unregister(LevelObject *object)
+{
+    auto location = _locations.find(object);
+    if (location == _locations.end())
+    {
+        return;
+    }
+
+    TypeObjects &type = _types[location->second.typeId];
+    int index = location->second.index;
+    int lastIndex = static_cast<int>(type.objects.size()) - 1;
+
+    // Order doesn't matter, so move the last object into the freed place
+    // instead of shifting all objects behind it.
+    if (index != lastIndex)
+    {
+        type.x[index] = type.x[lastIndex];
+        type.z[index] = type.z[lastIndex];
+        type.objects[index] = type.objects[lastIndex];
+        _locations[type.objects[index]].index = index;
+    }
+
+    type.x.pop_back();
+    type.z.pop_back();
+    type.objects.pop_back();
+    _locations.erase(location);
+}
+
+/**
+ * @brief Updates the stored position of the given object.
+ * 
+ * @param object The object that moved.
+ * @param position The new position of the object.
+ */
+void LevelObjectTypeRegistry::UpdatePosition(LevelObject *object, vector3df position)
+{
+    auto location = _locations.find(object);
+    if (location == _locations.end())
+    {
+        return;
+    }
+
+    TypeObjects &type = _types[location->second.typeId];
+    type.x[location->second.index] = position.X;
+    type.z[location->second.index] = position.Z;
+}
+
+/**
+ * @brief Returns whether the given object is registered, which is the case
+ * from its creation until its destruction, wherever it is.
+ */
+bool LevelObjectTypeRegistry::IsRegistered(LevelObject *object) const
+{
+    return _locations.count(object) > 0;
+}
+
+/**
+ * @brief Returns the number of registered objects of the given type.
+ */
+int LevelObjectTypeRegistry::GetObjectCount(unsigned short typeId)
+{
+    if (typeId >= _types.size())
+    {
+        return 0;
+    }
+
+    return static_cast<int>(_types[typeId].objects.size());
+}
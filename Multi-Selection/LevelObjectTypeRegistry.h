@@ -0,0 +1,161 @@
+/**
+ * @brief: Contains the LevelObjectTypeRegistry class header information.
+ * @file LevelObjectTypeRegistry.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <irrlicht.h>
+
+#include <Singleton.h>
+#include <LevelObject.h>
+
+#include "SelectionQuad.h"
+
+using irr::core::vector3df;
+
+/**
+ * @brief: Keeps a registry of the live LevelObjects of every type, with their
+ * ground positions stored contiguously, so queries like "all objects of type X
+ * within the view" are a tight loop over that type only.
+ *
+ * Objects register when they are created, update their position when they
+ * move, and unregister when they are destroyed. All three are constant time.
+ */
+class LevelObjectTypeRegistry : public Singleton<LevelObjectTypeRegistry>
+{
+public:
+    /**
+     * @brief Registers the given object under the given type.
+     * 
+     * @param object The object to register.
+     * @param typeId The type of the object.
+     * @param position The position of the object.
+     */
+    void Register(LevelObject *object, unsigned short typeId, vector3df position);
+
+    /**
+     * @brief Unregisters the given object, if it was registered.
+     * 
+     * @param object The object to unregister.
+     */
+    void Unregister(LevelObject *object);
+
+    /**
+     * @brief Updates the stored position of the given object.
+     * 
+     * @param object The object that moved.
+     * @param position The new position of the object.
+     */
+    void UpdatePosition(LevelObject *object, vector3df position);
+
+    /**
+     * @brief Returns whether the given object is registered, which is the case
+     * from its creation until its destruction, wherever it is.
+     */
+    bool IsRegistered(LevelObject *object) const;
+
+    /**
+     * @brief Returns the number of registered objects of the given type.
+     */
+    int GetObjectCount(unsigned short typeId);
+
+    /**
+     * @brief Calls the given visitor for every object of the given type whose
+     * position lies within the given axis-aligned ground rectangle.
+     * 
+     * @param typeId The type of the objects.
+     * @param minimum The minimum X and Z of the rectangle.
+     * @param maximum The maximum X and Z of the rectangle.
+     * @param visitor Called with a LevelObject * for every object in the rectangle.
+     */
+    template <typename Visitor>
+    void VisitObjectsOfTypeInArea(unsigned short typeId, vector3df minimum, vector3df maximum,
+                                  Visitor &&visitor)
+    {
+        if (typeId >= _types.size())
+        {
+            return;
+        }
+
+        const TypeObjects &type = _types[typeId];
+        int count = static_cast<int>(type.objects.size());
+
+        // Only touches the positions, unless an object is inside.
+        for (int i = 0; i < count; i++)
+        {
+            if (type.x[i] >= minimum.X && type.x[i] <= maximum.X &&
+                type.z[i] >= minimum.Z && type.z[i] <= maximum.Z)
+            {
+                visitor(type.objects[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls the given visitor for every object of the given type whose
+     * position lies within the given ground quad. The positions are tested
+     * against the quad in batches.
+     * 
+     * @param typeId The type of the objects.
+     * @param quad The ground quad to test the positions against.
+     * @param visitor Called with a LevelObject * for every object in the quad.
+     */
+    template <typename Visitor>
+    void VisitObjectsOfTypeInQuad(unsigned short typeId, const SelectionQuad &quad,
+                                  Visitor &&visitor)
+    {
+        if (typeId >= _types.size())
+        {
+            return;
+        }
+
+        const TypeObjects &type = _types[typeId];
+        int count = static_cast<int>(type.objects.size());
+
+        // The positions are already contiguous, so they can be tested as they are.
+        _insideIndices.resize(count);
+        int insideCount = quad.GetPointsInside(type.x.data(), type.z.data(), count,
+                                               _insideIndices.data());
+
+        for (int i = 0; i < insideCount; i++)
+        {
+            visitor(type.objects[_insideIndices[i]]);
+        }
+    }
+
+private:
+    /**
+     * @brief The registered objects of a single type, and their positions.
+     * The same index refers to the same object in all three lists.
+     */
+    struct TypeObjects
+    {
+        std::vector<float> x;
+        std::vector<float> z;
+        std::vector<LevelObject *> objects;
+    };
+
+    /**
+     * @brief Where a registered object is stored.
+     */
+    struct Location
+    {
+        unsigned short typeId;
+        int index;
+    };
+
+    // The registered objects of every type, by type id.
+    std::vector<TypeObjects> _types;
+
+    // The location of every registered object.
+    std::unordered_map<LevelObject *, Location> _locations;
+
+    // Reused to collect the results of quad tests.
+    std::vector<int> _insideIndices;
+};
@@ -11,37 +11,42 @@
 const float MultiSelector::DefaultLineDimensions::HEIGHT = 0.2f;
 const float MultiSelector::DefaultLineDimensions::THICKNESS = 2.f;
 
-MultiSelector::MultiSelector(CameraController* cameraController)
+/**
+ * @brief Creates the selection area visualization.
+ * 
+ * @param cameraController Used to get the mouse position in world space.
+ * @param index The index of the objects on the grid to query. Defaults to
+ * the one every placed object is registered in.
+ */
+MultiSelector::MultiSelector(CameraController* cameraController, LevelObjectIndex *index)
 {
     // Cache a reference to camera controller.
     _cameraController = cameraController;
 
-    // Initialize cube scene nodes for selection area visualization lines.
-    InitializeLine(_leftLine);
-    InitializeLine(_rightLine);
-    InitializeLine(_topLine);
-    InitializeLine(_bottomLine);
+    _index = index;
+
+    // Initialize scene node for the selection area visualization.
+    ISceneManager *sceneManager = ApplicationInfo::device->getSceneManager();
+    _rectangle = new SelectionRectangleSceneNode(sceneManager->getRootSceneNode(),
+                                                 sceneManager,
+                                                 // Bright green outline.
+                                                 SColor(255, 0, 255, 0),
+                                                 // Faint green fill.
+                                                 SColor(48, 0, 255, 0));
+    _rectangle->SetFillVisible(SHOW_SELECTION_AREA_FILL);
+    // The scene manager keeps the node alive from here on.
+    _rectangle->drop();
+    // Hide the rectangle for now.
+    _rectangle->setVisible(false);
 }
 
 /**
- * @brief Initializes a line.
+ * @brief Removes the selection area visualization from the scene.
  */
-void MultiSelector::InitializeLine(ISceneNode *&line)
+MultiSelector::~MultiSelector()
 {
-    // Add a cube scene node to visualize the line.
-    line = ApplicationInfo::device->getSceneManager()->addCubeSceneNode(1);
-    // Enable lighting so the line doesn't default to white.
-    line->setMaterialFlag(EMF_LIGHTING, true);
-    // For some reason, settings this to ECM_NONE prevents the line from
-    // becoming pure white, so do this in order to give the line a custom color.
-    line->getMaterial(0).ColorMaterial = irr::video::E_COLOR_MATERIAL::ECM_NONE;
-    // Make ambient and diffuse color black so the line doesn't receive light.
-    line->getMaterial(0).AmbientColor = {0};
-    line->getMaterial(0).DiffuseColor = {0};
-    // Make the line bright green.
-    line->getMaterial(0).EmissiveColor = {255, 0, 255, 0};
-    // Hide the line for now.
-    line->setVisible(false);
+    // The scene manager holds the only reference, so this deletes the node.
+    _rectangle->remove();
 }
 
 /**
@@ -52,28 +57,58 @@ void MultiSelector::Update()
     // Make sure the visualization is visible, otherwise we don't need to resize it.
     if (_active)
     {
-        // Update end point to match cursor position.
-        vector2di mouseScreenPos = InputHandler::GetInstance()->GetMouseState().position;
-        _endPoint = _cameraController->GetWorldPositionFromScreenPosition(mouseScreenPos);
+        // Update end point to match cursor position. Only raycasts if the
+        // mouse or camera moved since anything last asked for it.
+        CursorWorldPosition *cursor = CursorWorldPosition::GetInstance();
+        _endPoint = cursor->GetWorldPosition(_cameraController);
 
-        // Update selected area to match new end point.
-        _selectedArea.SetArea(_startPoint, _endPoint);
+        // If neither the mouse nor the camera moved, the selection area didn't change.
+        if (cursor->GetVersion() != _cursorVersion)
+        {
+            _cursorVersion = cursor->GetVersion();
+            UpdateSelectedArea();
+        }
 
-        // Only make lines visible when selection area goes beyond a certain size.
-        if (!_visible)
+        // Update the live preview even if the area stayed put, since objects
+        // move in and out of it.
+        if (_previewEnabled)
         {
-            int minSize = Grid::GetInstance()->GetGridNodeSize() / 5.f;
-            if (_selectedArea.bounds.Width > minSize || _selectedArea.bounds.Height > minSize)
-            {
-                // Make lines visible from this point onwards.
-                _visible = true;
-                ToggleVisualization();
-            }
+            UpdatePreview(GetSelectedNodeArea());
         }
+    }
+}
+
+/**
+ * @brief Updates the selected area and its visualization to the end point.
+ */
+void MultiSelector::UpdateSelectedArea()
+{
+    vector2di mouseScreenPos = InputHandler::GetInstance()->GetMouseState().position;
 
-        // Update selection visualization to new selected area.
-        UpdateVisualization();
+    // Update selected area to match new end point.
+    if (_selectionShape == eProjectedQuad)
+    {
+        UpdateProjectedQuad(mouseScreenPos);
     }
+    else
+    {
+        _selectedArea.SetArea(_startPoint, _endPoint);
+    }
+
+    // Only make lines visible when selection area goes beyond a certain size.
+    if (!_visible)
+    {
+        int minSize = Grid::GetInstance()->GetGridNodeSize() / 5.f;
+        if (_selectedArea.bounds.Width > minSize || _selectedArea.bounds.Height > minSize)
+        {
+            // Make lines visible from this point onwards.
+            _visible = true;
+            ToggleVisualization();
+        }
+    }
+
+    // Update selection visualization to new selected area.
+    UpdateVisualization();
 }
 
 /**
@@ -85,6 +120,15 @@ void MultiSelector::Activate(vector3df startPoint)
 
     // Set start point to given coordinate.
     SetStartPoint(startPoint);
+
+    // Remember where on the screen the selection started, for the projected quad.
+    _startScreenPosition = InputHandler::GetInstance()->GetMouseState().position;
+
+    // Make sure the next update recomputes the selection area for the new start point.
+    _cursorVersion = 0;
+
+    // Follow the cursor again, even if the area was fixed.
+    _hasFixedNodeArea = false;
 }
 
 /**
@@ -95,10 +139,47 @@ void MultiSelector::Deactivate()
     _active = false;
     _visible = false;
 
+    // Let all previewed objects leave.
+    if (_previewEnabled)
+    {
+        UpdatePreview(NodeArea());
+    }
+
     // Toggle line visibility.
     ToggleVisualization();
 }
 
+/**
+ * @brief Sets the shape used to determine the objects in the selection area.
+ */
+void MultiSelector::SetSelectionShape(SelectionShape shape)
+{
+    // The shapes preview differently, so let all previewed objects leave first.
+    if (_previewEnabled && shape != _selectionShape)
+    {
+        UpdatePreview(NodeArea());
+    }
+
+    _selectionShape = shape;
+
+    // Recompute the selection area with the new shape on the next update.
+    _cursorVersion = 0;
+}
+
+/**
+ * @brief Fixes the selection area to the given area in grid coordinates,
+ * instead of the area under the cursor, for selections made by code. The
+ * area is always selected as a rectangle, and the visualization isn't
+ * updated. Activating the selection area releases it.
+ * 
+ * @param area The area to select.
+ */
+void MultiSelector::SetSelectedNodeArea(NodeArea area)
+{
+    _hasFixedNodeArea = true;
+    _fixedNodeArea = area;
+}
+
 /**
  * @brief Stores all LevelObjects in the selection area that fit the criteria of
  * the specified filter function in the given list of objects. However, filtering
@@ -113,50 +194,458 @@ void MultiSelector::GetObjectsInArea(std::function<bool(LevelObject *)> filterFu
                                      std::vector<LevelObject *> *&objects,
                                      SelectionMode mode)
 {
-    // Initialize values for grid nodes in square function call.
-    vector2di bottomLeft = Grid::GetInstance()->GetCoordinateFromPosition(_selectedArea.bottomLeftCorner);
+    NodeArea area = GetSelectedNodeArea();
+
+    // Hard check if exactly 1 tile selected and no objects passed in.
+    if (area.bottomLeft == area.topRight && objects->size() == 0)
+    {
+        // 1 tile selected, perform selection on its level object if it has one.
+        VisitEntriesInArea(area.bottomLeft, area.topRight, [&](const LevelObjectIndex::Entry &entry)
+        {
+            LevelObject *object = entry.object;
+            PerformSelectionOnObject(objects, object, mode);
+        });
+
+        // Return, because we don't need to check for multiple tiles anymore.
+        return;
+    }
+
+    // Only visit the objects in the area, once each, instead of every node in it.
+    VisitSelectedObjects(LevelObjectIndex::MaskFilter(), [&](LevelObject *object)
+    {
+        if (filterFunction(object))
+        {
+            // Perform selection on level object.
+            PerformSelectionOnObject(objects, object, mode);
+        }
+    });
+}
+
+/**
+ * @brief Adds all LevelObjects in the selection area that fit the criteria of
+ * the specified filter function to the given selection, or removes them from
+ * it, depending on the mode. Each object costs constant time either way.
+ * As with the list overload, filtering is only applied when more than 1 tile
+ * is selected or the selection is not empty.
+ * 
+ * @param filterFunction Function to check the objects against.
+ * @param selection The selection to add the objects to or remove them from.
+ * @param mode The selection mode to perform on the found objects.
+ */
+void MultiSelector::GetObjectsInArea(std::function<bool(LevelObject *)> filterFunction,
+                                     SelectionSet &selection,
+                                     SelectionMode mode)
+{
+    SelectObjectsInArea(LevelObjectIndex::MaskFilter(), filterFunction, selection, mode);
+}
+
+/**
+ * @brief Adds all LevelObjects in the selection area whose category and owner
+ * bits pass the given mask filter to the given selection, or removes them
+ * from it, depending on the mode. Cheaper than a std::function filter, since
+ * the bits are tested on the index data without calling into the objects.
+ * As with the other overloads, filtering is only applied when more than 1
+ * tile is selected or the selection is not empty.
+ * 
+ * @param maskFilter The filter object masks must pass.
+ * @param selection The selection to add the objects to or remove them from.
+ * @param mode The selection mode to perform on the found objects.
+ */
+void MultiSelector::GetObjectsInArea(LevelObjectIndex::MaskFilter maskFilter,
+                                     SelectionSet &selection,
+                                     SelectionMode mode)
+{
+    SelectObjectsInArea(maskFilter, [](LevelObject *) { return true; }, selection, mode);
+}
+
+/**
+ * @brief Adds all objects of the given type whose position is visible on
+ * screen to the given selection, or removes them from it. Only scans the
+ * objects of that type, using the LevelObjectTypeRegistry. Meant for
+ * double-click "select all of this type" and for AI.
+ * 
+ * @param typeId The type of the objects to select.
+ * @param selection The selection to add the objects to or remove them from.
+ * @param mode The selection mode to perform on the found objects.
+ */
+void MultiSelector::SelectAllOfTypeOnScreen(unsigned short typeId, SelectionSet &selection, SelectionMode mode)
+{
+    // Project the corners of the screen onto the ground, to get the visible area.
+    irr::core::dimension2du screenSize = ApplicationInfo::device->getVideoDriver()->getScreenSize();
+    int right = static_cast<int>(screenSize.Width) - 1;
+    int bottom = static_cast<int>(screenSize.Height) - 1;
+
+    vector3df corners[4] =
+    {
+        _cameraController->GetWorldPositionFromScreenPosition(vector2di(0, 0)),
+        _cameraController->GetWorldPositionFromScreenPosition(vector2di(right, 0)),
+        _cameraController->GetWorldPositionFromScreenPosition(vector2di(right, bottom)),
+        _cameraController->GetWorldPositionFromScreenPosition(vector2di(0, bottom))
+    };
+
+    SelectionQuad viewQuad;
+    viewQuad.SetCorners(corners);
+
+    LevelObjectTypeRegistry::GetInstance()->VisitObjectsOfTypeInQuad(typeId, viewQuad, [&](LevelObject *object)
+    {
+        // Handle all selection modes.
+        switch (mode)
+        {
+            case SelectionMode::eAdd:
+            {
+                selection.Add(object);
+                break;
+            }
+            case SelectionMode::eSubtract:
+            {
+                selection.Remove(object);
+                break;
+            }
+        }
+    });
+}
+
+/**
+ * @brief Enables the live preview of the selection while dragging.
+ * Whenever the selection area changes, only the nodes that entered or left
+ * the area are visited, and the given functions are called for every object
+ * that entered or left it. An object covering multiple nodes enters when
+ * its first node enters the area, and leaves when its last node leaves it.
+ * All previewed objects leave when the selection area is deactivated.
+ * 
+ * @param onObjectEnter Called for every object that entered the selection area.
+ * @param onObjectLeave Called for every object that left the selection area.
+ */
+void MultiSelector::EnablePreview(std::function<void(LevelObject *)> onObjectEnter,
+                                  std::function<void(LevelObject *)> onObjectLeave)
+{
+    // End the preview with the previous functions first.
+    DisablePreview();
+
+    _previewEnabled = true;
+    _onObjectEnter = onObjectEnter;
+    _onObjectLeave = onObjectLeave;
+}
+
+/**
+ * @brief Disables the live preview of the selection, letting all previewed
+ * objects leave first.
+ */
+void MultiSelector::DisablePreview()
+{
+    if (_previewEnabled)
+    {
+        UpdatePreview(NodeArea());
+        _previewEnabled = false;
+    }
+}
+
+/**
+ * @brief Returns the selected area in grid coordinates.
+ */
+MultiSelector::NodeArea MultiSelector::GetSelectedNodeArea()
+{
+    if (_hasFixedNodeArea)
+    {
+        return _fixedNodeArea;
+    }
 
     vector3df endPos = vector3df(_selectedArea.bottomLeftCorner.X + _selectedArea.bounds.Width,
                                  0,
                                  _selectedArea.bottomLeftCorner.Z + _selectedArea.bounds.Height);
 
-    vector2di endCoord = Grid::GetInstance()->GetCoordinateFromPosition(endPos);
-    vector2di intBounds =
+    NodeArea area;
+    area.bottomLeft = Grid::GetInstance()->GetCoordinateFromPosition(_selectedArea.bottomLeftCorner);
+    area.topRight = Grid::GetInstance()->GetCoordinateFromPosition(endPos);
+    return area;
+}
+
+/**
+ * @brief Updates the ground quad and the selected area to the screen
+ * rectangle between the drag start and the given screen position.
+ * 
+ * @param screenPosition The current screen position of the cursor.
+ */
+void MultiSelector::UpdateProjectedQuad(vector2di screenPosition)
+{
+    // Project all 4 corners of the screen rectangle onto the ground. Under a
+    // tilted camera, these don't form an axis-aligned rectangle.
+    vector3df corners[4] =
     {
-        endCoord.X - bottomLeft.X,
-        endCoord.Y - bottomLeft.Y
+        _startPoint,
+        _cameraController->GetWorldPositionFromScreenPosition(vector2di(screenPosition.X, _startScreenPosition.Y)),
+        _endPoint,
+        _cameraController->GetWorldPositionFromScreenPosition(vector2di(_startScreenPosition.X, screenPosition.Y))
     };
+    _selectionQuad.SetCorners(corners);
 
-    auto gridNodes = Grid::GetInstance()->GetGridNodesInSquare(bottomLeft, intBounds);
+    // Use the bounds of the quad as the selected area, to find the candidates in.
+    vector3df minimum, maximum;
+    _selectionQuad.GetBounds(minimum, maximum);
+    _selectedArea.SetArea(minimum, maximum);
+}
 
-    // Hard check if exactly 1 tile selected and no objects passed in.
-    if (gridNodes.size() == 1 && objects->size() == 0)
+/**
+ * @brief Updates the preview to the given area. For the rectangle shape, only
+ * visits the nodes in the strips that differ between the given and the
+ * previewed area, unless objects may have been placed or removed since the
+ * last update, in which case it recounts the whole area. For the projected
+ * quad, whose shape can change without its bounds changing, tests every
+ * object in the bounds against the quad.
+ * 
+ * @param area The new area to preview. Empty to end the preview.
+ */
+void MultiSelector::UpdatePreview(NodeArea area)
+{
+    // Let all previewed objects leave when the preview ends, no matter which
+    // shape they were previewed with.
+    if (area.IsEmpty())
     {
-        // 1 tile selected, check if it has an object on it.
-        if (gridNodes.front()->HasLevelObject())
+        for (auto &nodeCount : _previewedNodeCounts)
         {
-            LevelObject *object = gridNodes.front()->GetLevelObject();
-            // Perform selection on level object.
-            PerformSelectionOnObject(objects, object, mode);
+            if (_onObjectLeave)
+            {
+                _onObjectLeave(nodeCount.first);
+            }
         }
 
-        // Return, because we don't need to check for multiple tiles anymore.
+        _previewedNodeCounts.clear();
+        _previewedArea = area;
+        return;
+    }
+
+    // The quad is previewed like it is selected, in full every time.
+    if (_selectionShape == eProjectedQuad)
+    {
+        UpdateQuadPreview();
+        _previewedArea = area;
         return;
     }
 
-    // Loop over all grid nodes.
-    for (GridNode *node : gridNodes)
+    // Objects may have moved since the last update, unless the index says
+    // nothing was placed or removed. The Grid can't tell, so without the index
+    // the whole area is recounted every time.
+    bool objectsChanged = !_index->IsPopulated() || _index->GetVersion() != _indexVersion;
+    _indexVersion = _index->GetVersion();
+    if (objectsChanged)
+    {
+        RecountPreview(area);
+        _previewedArea = area;
+        return;
+    }
+
+    // Nothing changed since the last update, so there's nothing to visit.
+    if (area.bottomLeft == _previewedArea.bottomLeft && area.topRight == _previewedArea.topRight)
+    {
+        return;
+    }
+
+    NodeArea strips[4];
+
+    // Count the nodes that entered the area first, so an object that has nodes
+    // both entering and leaving doesn't briefly leave.
+    int stripCount = GetAreaDifference(area, _previewedArea, strips);
+    _entriesInArea.clear();
+    for (int i = 0; i < stripCount; i++)
+    {
+        VisitEntriesInArea(strips[i].bottomLeft, strips[i].topRight, [this](const LevelObjectIndex::Entry &entry)
+        {
+            _entriesInArea.push_back(entry);
+        });
+    }
+
+    for (LevelObjectIndex::Entry &entry : _entriesInArea)
+    {
+        // The object enters when its first node enters.
+        if (_previewedNodeCounts[entry.object]++ == 0 && _onObjectEnter)
+        {
+            _onObjectEnter(entry.object);
+        }
+    }
+
+    // Then count the nodes that left the area.
+    stripCount = GetAreaDifference(_previewedArea, area, strips);
+    _entriesInArea.clear();
+    for (int i = 0; i < stripCount; i++)
+    {
+        VisitEntriesInArea(strips[i].bottomLeft, strips[i].topRight, [this](const LevelObjectIndex::Entry &entry)
+        {
+            _entriesInArea.push_back(entry);
+        });
+    }
+
+    for (LevelObjectIndex::Entry &entry : _entriesInArea)
     {
-        if (node->HasLevelObject())
+        auto nodeCount = _previewedNodeCounts.find(entry.object);
+        if (nodeCount == _previewedNodeCounts.end())
+        {
+            continue;
+        }
+
+        // The object leaves when its last node leaves.
+        if (--nodeCount->second == 0)
         {
-            LevelObject *object = node->GetLevelObject();
-            if (filterFunction(object))
+            _previewedNodeCounts.erase(nodeCount);
+            if (_onObjectLeave)
             {
-                // Perform selection on level object.
-                PerformSelectionOnObject(objects, object, mode);
+                _onObjectLeave(entry.object);
             }
         }
     }
+
+    _previewedArea = area;
+}
+
+/**
+ * @brief Recounts the nodes of every object in the given area from scratch.
+ * Objects that are new to the area enter, and previewed objects that no
+ * longer have any nodes in it leave.
+ * 
+ * @param area The area to preview.
+ */
+void MultiSelector::RecountPreview(NodeArea area)
+{
+    // Mark every previewed object as not counted yet.
+    for (auto &nodeCount : _previewedNodeCounts)
+    {
+        nodeCount.second = -1;
+    }
+
+    _entriesInArea.clear();
+    VisitEntriesInArea(area.bottomLeft, area.topRight, [this](const LevelObjectIndex::Entry &entry)
+    {
+        _entriesInArea.push_back(entry);
+    });
+
+    for (LevelObjectIndex::Entry &entry : _entriesInArea)
+    {
+        // Objects that weren't previewed yet are added with a count of 0.
+        int &nodeCount = _previewedNodeCounts[entry.object];
+        if (nodeCount == 0 && _onObjectEnter)
+        {
+            _onObjectEnter(entry.object);
+        }
+        nodeCount = std::max(nodeCount, 0) + 1;
+    }
+
+    // Previewed objects that weren't counted again left the area.
+    for (auto nodeCount = _previewedNodeCounts.begin(); nodeCount != _previewedNodeCounts.end();)
+    {
+        if (nodeCount->second > 0)
+        {
+            ++nodeCount;
+            continue;
+        }
+
+        LevelObject *object = nodeCount->first;
+        nodeCount = _previewedNodeCounts.erase(nodeCount);
+        if (_onObjectLeave)
+        {
+            _onObjectLeave(object);
+        }
+    }
+}
+
+/**
+ * @brief Updates the preview to the objects in the projected quad, the same
+ * objects a selection would get. Objects that are new to the quad enter,
+ * and previewed objects that are no longer in it leave.
+ */
+void MultiSelector::UpdateQuadPreview()
+{
+    // Objects in the quad are marked with 2 this update, and 1 from then on.
+    VisitSelectedObjects(LevelObjectIndex::MaskFilter(), [this](LevelObject *object)
+    {
+        int &mark = _previewedNodeCounts[object];
+        if (mark == 0 && _onObjectEnter)
+        {
+            _onObjectEnter(object);
+        }
+        mark = 2;
+    });
+
+    // Previewed objects that weren't marked again left the quad.
+    for (auto mark = _previewedNodeCounts.begin(); mark != _previewedNodeCounts.end();)
+    {
+        if (mark->second == 2)
+        {
+            mark->second = 1;
+            ++mark;
+            continue;
+        }
+
+        LevelObject *object = mark->first;
+        mark = _previewedNodeCounts.erase(mark);
+        if (_onObjectLeave)
+        {
+            _onObjectLeave(object);
+        }
+    }
+}
+
+/**
+ * @brief Stores the parts of the first area that lie outside of the second
+ * area, as at most 4 non-overlapping strips.
+ * 
+ * @param area The area to subtract from.
+ * @param subtractedArea The area to subtract.
+ * @param strips Filled with the resulting strips.
+ * @return int The number of resulting strips.
+ */
+int MultiSelector::GetAreaDifference(const NodeArea &area,
+                                     const NodeArea &subtractedArea,
+                                     NodeArea strips[4])
+{
+    if (area.IsEmpty())
+    {
+        return 0;
+    }
+
+    // Get the overlap of both areas.
+    NodeArea overlap;
+    overlap.bottomLeft.X = std::max(area.bottomLeft.X, subtractedArea.bottomLeft.X);
+    overlap.bottomLeft.Y = std::max(area.bottomLeft.Y, subtractedArea.bottomLeft.Y);
+    overlap.topRight.X = std::min(area.topRight.X, subtractedArea.topRight.X);
+    overlap.topRight.Y = std::min(area.topRight.Y, subtractedArea.topRight.Y);
+
+    // Without overlap, nothing is subtracted.
+    if (overlap.IsEmpty())
+    {
+        strips[0] = area;
+        return 1;
+    }
+
+    int stripCount = 0;
+
+    // The full-width strips below and above the overlap.
+    if (area.bottomLeft.Y < overlap.bottomLeft.Y)
+    {
+        strips[stripCount].bottomLeft = area.bottomLeft;
+        strips[stripCount].topRight = vector2di(area.topRight.X, overlap.bottomLeft.Y - 1);
+        stripCount++;
+    }
+    if (area.topRight.Y > overlap.topRight.Y)
+    {
+        strips[stripCount].bottomLeft = vector2di(area.bottomLeft.X, overlap.topRight.Y + 1);
+        strips[stripCount].topRight = area.topRight;
+        stripCount++;
+    }
+
+    // The strips left and right of the overlap, in the rows of the overlap.
+    if (area.bottomLeft.X < overlap.bottomLeft.X)
+    {
+        strips[stripCount].bottomLeft = vector2di(area.bottomLeft.X, overlap.bottomLeft.Y);
+        strips[stripCount].topRight = vector2di(overlap.bottomLeft.X - 1, overlap.topRight.Y);
+        stripCount++;
+    }
+    if (area.topRight.X > overlap.topRight.X)
+    {
+        strips[stripCount].bottomLeft = vector2di(overlap.topRight.X + 1, overlap.bottomLeft.Y);
+        strips[stripCount].topRight = vector2di(area.topRight.X, overlap.topRight.Y);
+        stripCount++;
+    }
+
+    return stripCount;
 }
 
 /**
@@ -206,10 +695,7 @@ void MultiSelector::SetStartPoint(vector3df coordinate)
  */
 void MultiSelector::ToggleVisualization()
 {
-    _leftLine->setVisible(_visible);
-    _rightLine->setVisible(_visible);
-    _topLine->setVisible(_visible);
-    _bottomLine->setVisible(_visible);
+    _rectangle->setVisible(_visible);
 }
 
 /**
@@ -217,77 +703,27 @@ void MultiSelector::ToggleVisualization()
  */
 void MultiSelector::UpdateVisualization()
 {
-    vector3df center = _selectedArea.GetCenter();
-
-    // Left line.
-    _leftLine->setPosition
-    (
-        {
-            _selectedArea.bottomLeftCorner.X,
-            center.Y,
-            center.Z
-        }
-    );
-    _leftLine->setScale
-    (
-        {
-            DefaultLineDimensions::THICKNESS,
-            DefaultLineDimensions::HEIGHT,
-            _selectedArea.bounds.Height + DefaultLineDimensions::THICKNESS
-        }
-    );
+    // Draw the rectangle slightly above the ground. The scene node skips the
+    // update itself if the area didn't change.
+    vector3df bottomLeftCorner = _selectedArea.bottomLeftCorner;
+    bottomLeftCorner.Y += DefaultLineDimensions::HEIGHT / 2.f;
 
-    // Right line.
-    _rightLine->setPosition
-    (
-        {
-            _selectedArea.bottomLeftCorner.X + _selectedArea.bounds.Width,
-            center.Y,
-            center.Z
-        }
-    );
-    _rightLine->setScale
-    (
+    // Draw the projected quad itself, so the outline matches the screen rectangle.
+    if (_selectionShape == eProjectedQuad)
+    {
+        vector3df corners[4];
+        for (int i = 0; i < 4; i++)
         {
-            DefaultLineDimensions::THICKNESS,
-            DefaultLineDimensions::HEIGHT,
-            _selectedArea.bounds.Height + DefaultLineDimensions::THICKNESS
+            corners[i] = _selectionQuad.GetCorner(i);
+            corners[i].Y = bottomLeftCorner.Y;
         }
-    );
 
-    // Bottom line.
-    _bottomLine->setPosition
-    (
-        {
-            center.X,
-            center.Y,
-            _selectedArea.bottomLeftCorner.Z
-        }
-    );
-    _bottomLine->setScale
-    (
-        {
-            _selectedArea.bounds.Width + DefaultLineDimensions::THICKNESS,
-            DefaultLineDimensions::HEIGHT,
-            DefaultLineDimensions::THICKNESS
-        }
-    );
+        _rectangle->SetCorners(corners, DefaultLineDimensions::THICKNESS);
+        return;
+    }
 
-    // Top line.
-    _topLine->setPosition
-    (
-        {
-            center.X,
-            center.Y,
-            _selectedArea.bottomLeftCorner.Z + _selectedArea.bounds.Height
-        }
-    );
-    _topLine->setScale
-    (
-        {
-            _selectedArea.bounds.Width + DefaultLineDimensions::THICKNESS,
-            DefaultLineDimensions::HEIGHT,
-            DefaultLineDimensions::THICKNESS
-        }
-    );
+    _rectangle->SetRectangle(bottomLeftCorner,
+                             _selectedArea.bounds.Width,
+                             _selectedArea.bounds.Height,
+                             DefaultLineDimensions::THICKNESS);
 }
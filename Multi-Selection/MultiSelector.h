@@ -7,9 +7,12 @@
 
 #pragma once
 
+#include <cstdio>
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <irrlicht.h>
 
@@ -20,28 +23,44 @@
 #include <LevelObject.h>
 #include <Grid.h>
 #include <HeadsUpDisplay.h>
+#include <CursorWorldPosition.h>
+
+#include "LevelObjectIndex.h"
+#include "SelectionSet.h"
+#include "SelectionRectangleSceneNode.h"
+#include "SelectionQuad.h"
+#include "LevelObjectTypeRegistry.h"
+
+// Whether to draw a translucent fill inside the selection area outline.
+#define SHOW_SELECTION_AREA_FILL true
 
 using irr::core::dimension2df;
 using irr::core::vector3df;
 using irr::core::vector2di;
-using irr::scene::IMeshSceneNode;
-using irr::video::EMF_LIGHTING;
 
 class Selection;
 
 /**
- * @brief: Manages 4 cube scene nodes that represent a selection area.
+ * @brief: Manages a scene node that draws the selection area.
  * Has functions for getting the objects in the selected area.
  */
 class MultiSelector : public IUpdatable
 {
 public:
-    MultiSelector(CameraController* cameraController);
+    /**
+     * @brief Creates the selection area visualization.
+     * 
+     * @param cameraController Used to get the mouse position in world space.
+     * @param index The index of the objects on the grid to query. Defaults to
+     * the one every placed object is registered in.
+     */
+    MultiSelector(CameraController* cameraController,
+                  LevelObjectIndex *index = LevelObjectIndex::GetInstance());
 
     /**
-     * @brief Initializes a line.
+     * @brief Removes the selection area visualization from the scene.
      */
-    void InitializeLine(ISceneNode *&line);
+    ~MultiSelector();
 
     // Determines whether to select or deselect given units.
     enum SelectionMode
@@ -50,9 +69,21 @@ public:
         eSubtract
     };
 
+    // Determines which objects lie in the selection area.
+    enum SelectionShape
+    {
+        // Objects on the nodes in the axis-aligned world rectangle between the
+        // points under the drag start and the cursor.
+        eRectangle,
+        // Objects whose position lies in the ground quad under the screen
+        // rectangle between the drag start and the cursor. Matches what the
+        // player sees under a tilted camera.
+        eProjectedQuad
+    };
+
     /**
-     * @brief Contains the default values for visual line thickness and height.
-     * Values defined at top of cpp.
+     * @brief Contains the default values for visual line thickness and the
+     * height of the lines above the ground. Values defined at top of cpp.
      */
     struct DefaultLineDimensions
     {
@@ -91,6 +122,20 @@ public:
         }
     };
 
+    /**
+     * @brief Represents a selected area in grid coordinates, both corners inclusive.
+     */
+    struct NodeArea
+    {
+        vector2di bottomLeft = vector2di(0);
+        vector2di topRight = vector2di(-1);
+
+        bool IsEmpty() const
+        {
+            return bottomLeft.X > topRight.X || bottomLeft.Y > topRight.Y;
+        }
+    };
+
     /**
      * @brief Resizes the selection area to follow the mouse if it is visible.
      */
@@ -106,6 +151,21 @@ public:
      */
     void Deactivate();
 
+    /**
+     * @brief Sets the shape used to determine the objects in the selection area.
+     */
+    void SetSelectionShape(SelectionShape shape);
+
+    /**
+     * @brief Fixes the selection area to the given area in grid coordinates,
+     * instead of the area under the cursor, for selections made by code. The
+     * area is always selected as a rectangle, and the visualization isn't
+     * updated. Activating the selection area releases it.
+     * 
+     * @param area The area to select.
+     */
+    void SetSelectedNodeArea(NodeArea area);
+
     /**
      * @brief Stores all LevelObjects in the selection area that fit the criteria of
      * the specified filter function in the given list of objects. However, filtering
@@ -120,14 +180,126 @@ public:
                           std::vector<LevelObject *> *&objects,
                           SelectionMode mode);
 
+    /**
+     * @brief Adds all LevelObjects in the selection area that fit the criteria of
+     * the specified filter function to the given selection, or removes them from
+     * it, depending on the mode. Each object costs constant time either way.
+     * As with the list overload, filtering is only applied when more than 1 tile
+     * is selected or the selection is not empty.
+     * 
+     * @param filterFunction Function to check the objects against.
+     * @param selection The selection to add the objects to or remove them from.
+     * @param mode The selection mode to perform on the found objects.
+     */
+    void GetObjectsInArea(std::function<bool(LevelObject *)> filterFunction,
+                          SelectionSet &selection,
+                          SelectionMode mode);
+
+    /**
+     * @brief Adds all LevelObjects in the selection area whose category and owner
+     * bits pass the given mask filter to the given selection, or removes them
+     * from it, depending on the mode. Cheaper than a std::function filter, since
+     * the bits are tested on the index data without calling into the objects.
+     * As with the other overloads, filtering is only applied when more than 1
+     * tile is selected or the selection is not empty.
+     * 
+     * @param maskFilter The filter object masks must pass.
+     * @param selection The selection to add the objects to or remove them from.
+     * @param mode The selection mode to perform on the found objects.
+     */
+    void GetObjectsInArea(LevelObjectIndex::MaskFilter maskFilter,
+                          SelectionSet &selection,
+                          SelectionMode mode);
+
+    /**
+     * @brief Adds all objects of the given type whose position is visible on
+     * screen to the given selection, or removes them from it. Only scans the
+     * objects of that type, using the LevelObjectTypeRegistry. Meant for
+     * double-click "select all of this type" and for AI.
+     * 
+     * @param typeId The type of the objects to select.
+     * @param selection The selection to add the objects to or remove them from.
+     * @param mode The selection mode to perform on the found objects.
+     */
+    void SelectAllOfTypeOnScreen(unsigned short typeId, SelectionSet &selection, SelectionMode mode);
+
+    /**
+     * @brief Writes every LevelObject in the selection area that passes the given
+     * filter to the given output iterator. Unlike the std::function overload,
+     * the filter is inlined and nothing is allocated, so use this for queries
+     * that run often, writing into caller-owned storage.
+     * 
+     * @param filter Called with a LevelObject *. Only objects it returns true for are written.
+     * @param output The iterator to write the found objects to.
+     * @return OutputIterator The iterator past the last written object.
+     */
+    template <typename Filter, typename OutputIterator>
+    OutputIterator GetObjectsInArea(Filter &&filter, OutputIterator output)
+    {
+        VisitSelectedObjects(LevelObjectIndex::MaskFilter(), [&](LevelObject *object)
+        {
+            if (filter(object))
+            {
+                *output++ = object;
+            }
+        });
+
+        return output;
+    }
+
+    /**
+     * @brief Enables the live preview of the selection while dragging.
+     * Whenever the selection area changes, only the nodes that entered or left
+     * the area are visited, and the given functions are called for every object
+     * that entered or left it. An object covering multiple nodes enters when
+     * its first node enters the area, and leaves when its last node leaves it.
+     * With the projected quad shape, objects enter and leave as their positions
+     * enter and leave the quad, so the preview matches what would be selected.
+     * All previewed objects leave when the selection area is deactivated.
+     * 
+     * @param onObjectEnter Called for every object that entered the selection area.
+     * @param onObjectLeave Called for every object that left the selection area.
+     */
+    void EnablePreview(std::function<void(LevelObject *)> onObjectEnter,
+                       std::function<void(LevelObject *)> onObjectLeave);
+
+    /**
+     * @brief Disables the live preview of the selection, letting all previewed
+     * objects leave first.
+     */
+    void DisablePreview();
+
 private:
-    // Selection area visualization lines. These are stretched cube scene nodes.
-    ISceneNode *_leftLine, *_rightLine, *_topLine, *_bottomLine;
+    // Selection area visualization. Draws the outline and fill in a single draw call.
+    SelectionRectangleSceneNode *_rectangle = nullptr;
 
     // The starting and ending points of the current selection area.
     vector3df _startPoint = vector3df(0);
     vector3df _endPoint = vector3df(0);
 
+    // The screen position the current selection started at.
+    vector2di _startScreenPosition = vector2di(0);
+
+    // The shape used to determine the objects in the selection area.
+    SelectionShape _selectionShape = eRectangle;
+
+    // The ground quad under the screen rectangle. Only used for eProjectedQuad.
+    SelectionQuad _selectionQuad = SelectionQuad();
+
+    // The objects in the bounds of the quad and their positions, tested against
+    // the quad in batches. Kept between queries, so their memory is reused.
+    std::vector<LevelObject *> _candidateObjects;
+    std::vector<float> _candidateX;
+    std::vector<float> _candidateZ;
+    std::vector<int> _insideIndices;
+
+    // The version of the cursor world position the selection area was last
+    // updated for. 0 forces an update.
+    unsigned int _cursorVersion = 0;
+
+    // The version of the index the preview was last updated for.
+    unsigned int _indexVersion = 0;
+
     // Whether the selection area is active.
     bool _active = false;
 
@@ -139,6 +311,270 @@ private:
 
     // Used to get mouse position in world space.
     CameraController* _cameraController = nullptr;
+
+    // The index of the objects on the grid.
+    LevelObjectIndex *_index = nullptr;
+
+    // Whether the selected area is fixed by SetSelectedNodeArea, and to what.
+    bool _hasFixedNodeArea = false;
+    NodeArea _fixedNodeArea = NodeArea();
+
+    // The occupied nodes found by the last area query. Kept between queries,
+    // so its memory is reused.
+    std::vector<LevelObjectIndex::Entry> _entriesInArea;
+
+    // The objects the Grid scan of the current object query already visited.
+    // Kept between queries, so its buckets are reused.
+    std::unordered_set<LevelObject *> _visitedObjects;
+
+    // Whether the live preview is enabled.
+    bool _previewEnabled = false;
+
+    // Called for every object that entered or left the previewed area.
+    std::function<void(LevelObject *)> _onObjectEnter;
+    std::function<void(LevelObject *)> _onObjectLeave;
+
+    // The area the preview was last updated for. Empty while inactive.
+    NodeArea _previewedArea = NodeArea();
+
+    // For every previewed object, the number of its nodes in the previewed area.
+    // For the projected quad, only marks which objects are previewed.
+    std::unordered_map<LevelObject *, int> _previewedNodeCounts;
+
+    /**
+     * @brief Returns the selected area in grid coordinates.
+     */
+    NodeArea GetSelectedNodeArea();
+
+    /**
+     * @brief Calls the given visitor for every occupied node in the given area.
+     * Asks the index if it is populated, and scans the Grid nodes otherwise.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param visitor Called with a const LevelObjectIndex::Entry & for every occupied node.
+     */
+    template <typename Visitor>
+    void VisitEntriesInArea(vector2di bottomLeft, vector2di topRight, Visitor &&visitor)
+    {
+        if (_index->IsPopulated())
+        {
+            _index->VisitEntriesInArea(bottomLeft, topRight, visitor);
+            return;
+        }
+
+        // Clamp the area to the grid.
+        Grid *grid = Grid::GetInstance();
+        irr::core::dimension2du gridDimensions = grid->GetGridDimensions();
+        bottomLeft.X = std::max(bottomLeft.X, 0);
+        bottomLeft.Y = std::max(bottomLeft.Y, 0);
+        topRight.X = std::min(topRight.X, static_cast<int>(gridDimensions.Width) - 1);
+        topRight.Y = std::min(topRight.Y, static_cast<int>(gridDimensions.Height) - 1);
+
+        // Check every node in the area for an object. The Grid doesn't know
+        // about object ids, so those are left empty, and masks are derived
+        // through the index's mask function.
+        LevelObjectIndex::Entry entry;
+        entry.objectId = -1;
+
+        for (int y = bottomLeft.Y; y <= topRight.Y; y++)
+        {
+            for (int x = bottomLeft.X; x <= topRight.X; x++)
+            {
+                entry.coordinate = vector2di(x, y);
+                GridNode *node = grid->GetGridNodeAtCoordinate(entry.coordinate);
+                if (node->HasLevelObject())
+                {
+                    entry.object = node->GetLevelObject();
+                    entry.mask = _index->GetObjectMask(entry.object);
+                    visitor(entry);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Calls the given visitor for the objects in the given area whose
+     * mask passes the given filter, once each. Asks the index if it is populated.
+     * Otherwise scans the Grid nodes, remembering the objects it visited so an
+     * object covering several nodes is still visited once, and derives masks
+     * through the index's mask function, since the Grid doesn't know about them.
+     * 
+     * @param bottomLeft The coordinate of the bottom left node of the area.
+     * @param topRight The coordinate of the top right node of the area, inclusive.
+     * @param maskFilter The filter object masks must pass.
+     * @param visitor Called with a LevelObject * for every object.
+     */
+    template <typename Visitor>
+    void VisitObjectsInArea(vector2di bottomLeft, vector2di topRight,
+                            LevelObjectIndex::MaskFilter maskFilter, Visitor &&visitor)
+    {
+        if (_index->IsPopulated())
+        {
+            _index->VisitObjectsInArea(bottomLeft, topRight, maskFilter, visitor);
+            return;
+        }
+
+        // Without a mask function every mask is 0, so only an empty filter passes.
+        if (!maskFilter.IsEmpty() && !_index->HasMaskFunction())
+        {
+            printf("Tried to filter objects by mask without a mask function set on the index.\n");
+        }
+
+        _visitedObjects.clear();
+        VisitEntriesInArea(bottomLeft, topRight, [&](const LevelObjectIndex::Entry &entry)
+        {
+            if (maskFilter.Passes(entry.mask) && _visitedObjects.insert(entry.object).second)
+            {
+                visitor(entry.object);
+            }
+        });
+    }
+
+    /**
+     * @brief Calls the given visitor once for every object in the selection
+     * area, according to the selection shape. A single selected node is always
+     * treated as a rectangle, so clicking an object selects it, and so is a
+     * fixed area, which has no quad.
+     * 
+     * @param maskFilter The filter object masks must pass.
+     * @param visitor Called with a LevelObject * for every object.
+     */
+    template <typename Visitor>
+    void VisitSelectedObjects(LevelObjectIndex::MaskFilter maskFilter, Visitor &&visitor)
+    {
+        NodeArea area = GetSelectedNodeArea();
+
+        if (_selectionShape == eRectangle || _hasFixedNodeArea || area.bottomLeft == area.topRight)
+        {
+            VisitObjectsInArea(area.bottomLeft, area.topRight, maskFilter, visitor);
+            return;
+        }
+
+        // Gather the objects in the bounds of the quad, with their positions.
+        _candidateObjects.clear();
+        _candidateX.clear();
+        _candidateZ.clear();
+        VisitObjectsInArea(area.bottomLeft, area.topRight, maskFilter, [this](LevelObject *object)
+        {
+            vector3df position = object->GetPosition();
+            _candidateObjects.push_back(object);
+            _candidateX.push_back(position.X);
+            _candidateZ.push_back(position.Z);
+        });
+
+        // Test all of them against the quad in batches.
+        _insideIndices.resize(_candidateObjects.size());
+        int insideCount = _selectionQuad.GetPointsInside(_candidateX.data(), _candidateZ.data(),
+                                                         static_cast<int>(_candidateObjects.size()),
+                                                         _insideIndices.data());
+
+        for (int i = 0; i < insideCount; i++)
+        {
+            visitor(_candidateObjects[_insideIndices[i]]);
+        }
+    }
+
+    /**
+     * @brief Adds the objects in the selection area that pass both filters to
+     * the given selection, or removes them from it. Neither filter is applied
+     * when a single tile is selected into an empty selection.
+     * 
+     * @param maskFilter The filter object masks must pass.
+     * @param filter Called with a LevelObject *. Only objects it returns true for are used.
+     * @param selection The selection to add the objects to or remove them from.
+     * @param mode The selection mode to perform on the found objects.
+     */
+    template <typename Filter>
+    void SelectObjectsInArea(LevelObjectIndex::MaskFilter maskFilter, Filter &&filter,
+                             SelectionSet &selection, SelectionMode mode)
+    {
+        NodeArea area = GetSelectedNodeArea();
+
+        // Only apply the filters when it's not a single tile selected into an empty selection.
+        bool applyFilter = !(area.bottomLeft == area.topRight && selection.GetCount() == 0);
+        if (!applyFilter)
+        {
+            maskFilter = LevelObjectIndex::MaskFilter();
+        }
+
+        VisitSelectedObjects(maskFilter, [&](LevelObject *object)
+        {
+            if (applyFilter && !filter(object))
+            {
+                return;
+            }
+
+            // Handle all selection modes.
+            switch (mode)
+            {
+                case SelectionMode::eAdd:
+                {
+                    selection.Add(object);
+                    break;
+                }
+                case SelectionMode::eSubtract:
+                {
+                    selection.Remove(object);
+                    break;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Updates the ground quad and the selected area to the screen
+     * rectangle between the drag start and the given screen position.
+     * 
+     * @param screenPosition The current screen position of the cursor.
+     */
+    void UpdateProjectedQuad(vector2di screenPosition);
+
+    /**
+     * @brief Updates the selected area and its visualization to the end point.
+     */
+    void UpdateSelectedArea();
+
+    /**
+     * @brief Updates the preview to the given area. For the rectangle shape, only
+     * visits the nodes in the strips that differ between the given and the
+     * previewed area, unless objects may have been placed or removed since the
+     * last update, in which case it recounts the whole area. For the projected
+     * quad, whose shape can change without its bounds changing, tests every
+     * object in the bounds against the quad.
+     * 
+     * @param area The new area to preview. Empty to end the preview.
+     */
+    void UpdatePreview(NodeArea area);
+
+    /**
+     * @brief Recounts the nodes of every object in the given area from scratch.
+     * Objects that are new to the area enter, and previewed objects that no
+     * longer have any nodes in it leave.
+     * 
+     * @param area The area to preview.
+     */
+    void RecountPreview(NodeArea area);
+
+    /**
+     * @brief Updates the preview to the objects in the projected quad, the same
+     * objects a selection would get. Objects that are new to the quad enter,
+     * and previewed objects that are no longer in it leave.
+     */
+    void UpdateQuadPreview();
+
+    /**
+     * @brief Stores the parts of the first area that lie outside of the second
+     * area, as at most 4 non-overlapping strips.
+     * 
+     * @param area The area to subtract from.
+     * @param subtractedArea The area to subtract.
+     * @param strips Filled with the resulting strips.
+     * @return int The number of resulting strips.
+     */
+    static int GetAreaDifference(const NodeArea &area,
+                                 const NodeArea &subtractedArea,
+                                 NodeArea strips[4]);
     
     /**
      * @brief Applies the specified selectionmode on the specified object.
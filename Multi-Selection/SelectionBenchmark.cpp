@@ -0,0 +1,281 @@
+/**
+ * @brief: Contains the SelectionBenchmark class function implementations.
+ * @file SelectionBenchmark.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "SelectionBenchmark.h"
+#include "StringHelper.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// The width and height of the synthetic grid, in nodes.
+#define BENCHMARK_GRID_SIZE 1024
+// The fraction of nodes of the synthetic grid that hold an object.
+#define BENCHMARK_OCCUPANCY_DENSITY 0.1f
+// The width and height of the small and medium query areas, in nodes.
+#define SMALL_AREA_SIZE 16
+#define MEDIUM_AREA_SIZE 128
+// How many times each benchmark repeats its query.
+#define QUERY_COUNT 200
+// The seed of the object placement, so every run measures the same grid.
+#define BENCHMARK_SEED 12345
+
+/**
+ * @brief Runs the benchmarks when F10 is pressed.
+ */
+void SelectionBenchmark::Update()
+{
+    if (InputHandler::GetInstance()->IsKeyPressed(irr::KEY_F10))
+    {
+        RunAll();
+    }
+}
+
+/**
+ * @brief A named size of the query areas.
+ */
+struct AreaSize
+{
+    const char *name;
+    int size;
+};
+
+// The sizes of the query areas. Areas are clamped to the grid, so INT_MAX is the full map.
+static const AreaSize AREA_SIZES[] =
+{
+    {"small", SMALL_AREA_SIZE},
+    {"medium", MEDIUM_AREA_SIZE},
+    {"full map", INT_MAX}
+};
+
+/**
+ * @brief Runs all benchmarks and prints the results to the console.
+ */
+void SelectionBenchmark::RunAll()
+{
+    if (!_selector)
+    {
+        // No camera is needed, since the area is fixed instead of following the cursor.
+        _selector.reset(new MultiSelector(nullptr, &_index));
+    }
+
+    RunGridBenchmarks();
+    RunIndexBenchmarks();
+}
+
+/**
+ * @brief Times the list overload of GetObjectsInArea on the live Grid, over
+ * small, medium and full-map areas, and prints the results.
+ */
+void SelectionBenchmark::RunGridBenchmarks()
+{
+    dimension2du gridDimensions = Grid::GetInstance()->GetGridDimensions();
+    BenchmarkHarness::PrintTitle(StringHelper::Format("Selection benchmark, live %ux%u Grid, list overload",
+                                                      gridDimensions.Width, gridDimensions.Height));
+
+    if (gridDimensions.Width == 0 || gridDimensions.Height == 0)
+    {
+        printf("No level is loaded, so there is no Grid to scan.\n");
+        return;
+    }
+
+    // An unpopulated index makes the selector scan the Grid, like it does in the game.
+    _index.Initialize(dimension2du(0, 0));
+
+    for (const AreaSize &areaSize : AREA_SIZES)
+    {
+        MultiSelector::NodeArea area = GetCenteredArea(areaSize.size, gridDimensions);
+        vector2di areaDimensions = area.topRight - area.bottomLeft + vector2di(1);
+
+        for (MultiSelector::SelectionMode mode : {MultiSelector::eAdd, MultiSelector::eSubtract})
+        {
+            int objectsPerQuery = 0;
+            BenchmarkHarness::Result result = BenchmarkListQuery(area, mode, objectsPerQuery);
+
+            BenchmarkHarness::PrintResult(StringHelper::Format("%s, %s %dx%d",
+                                                               mode == MultiSelector::eAdd ? "eAdd" : "eSubtract",
+                                                               areaSize.name, areaDimensions.X, areaDimensions.Y),
+                                          result,
+                                          StringHelper::Format(" %8d objects", objectsPerQuery));
+        }
+    }
+}
+
+/**
+ * @brief Times the SelectionSet overload of GetObjectsInArea on the synthetic
+ * grid, over small, medium and full-map areas, and prints the results.
+ */
+void SelectionBenchmark::RunIndexBenchmarks()
+{
+    BenchmarkHarness::PrintTitle(StringHelper::Format("Selection benchmark, %dx%d grid, %.0f%% occupied",
+                                                      BENCHMARK_GRID_SIZE, BENCHMARK_GRID_SIZE,
+                                                      BENCHMARK_OCCUPANCY_DENSITY * 100.f));
+
+    FillIndex(_index);
+    dimension2du gridDimensions(BENCHMARK_GRID_SIZE, BENCHMARK_GRID_SIZE);
+
+    for (const AreaSize &areaSize : AREA_SIZES)
+    {
+        MultiSelector::NodeArea area = GetCenteredArea(areaSize.size, gridDimensions);
+        int areaWidth = area.topRight.X - area.bottomLeft.X + 1;
+
+        for (MultiSelector::SelectionMode mode : {MultiSelector::eAdd, MultiSelector::eSubtract})
+        {
+            int objectsPerQuery = 0;
+            BenchmarkHarness::Result result = BenchmarkSetQuery(area, mode, objectsPerQuery);
+
+            BenchmarkHarness::PrintResult(StringHelper::Format("%s, %s %dx%d",
+                                                               mode == MultiSelector::eAdd ? "eAdd" : "eSubtract",
+                                                               areaSize.name, areaWidth, areaWidth),
+                                          result,
+                                          StringHelper::Format(" %8d objects", objectsPerQuery));
+        }
+    }
+
+    // Empty the index again, so the next Grid benchmarks find it unpopulated,
+    // and release the memory of the synthetic grid until the next run.
+    _index = LevelObjectIndex();
+    _standInObjects.clear();
+    _standInObjects.shrink_to_fit();
+}
+
+/**
+ * @brief Measures a single list overload GetObjectsInArea call over the
+ * given area. In eAdd mode, every query starts from an empty list. In
+ * eSubtract mode, every query deselects the objects in the area through
+ * Selection::DeselectObject. Only the query itself is timed.
+ *
+ * @param area The area to query.
+ * @param mode The selection mode to query with.
+ * @param objectsPerQuery Set to the number of objects in the area.
+ * @return BenchmarkHarness::Result The cost of a single query.
+ */
+BenchmarkHarness::Result SelectionBenchmark::BenchmarkListQuery(MultiSelector::NodeArea area,
+                                                                MultiSelector::SelectionMode mode,
+                                                                int &objectsPerQuery)
+{
+    _selector->SetSelectedNodeArea(area);
+
+    // A filter that lets everything through, like selecting all objects would.
+    std::function<bool(LevelObject *)> acceptAll = [](LevelObject *) { return true; };
+
+    std::vector<LevelObject *> objectList;
+    std::vector<LevelObject *> *objects = &objectList;
+
+    // Count the objects in the area once, without timing it.
+    _selector->GetObjectsInArea(acceptAll, objects, MultiSelector::eAdd);
+    objectsPerQuery = static_cast<int>(objectList.size());
+
+    BenchmarkHarness harness;
+
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        // Every query starts from an empty list, like a new drag does.
+        objectList.clear();
+
+        harness.Start();
+        _selector->GetObjectsInArea(acceptAll, objects, mode);
+        harness.Stop();
+    }
+
+    return harness.GetResult(QUERY_COUNT);
+}
+
+/**
+ * @brief Measures a single SelectionSet overload GetObjectsInArea call over
+ * the given area. In eAdd mode, every query starts from an empty selection.
+ * In eSubtract mode, every query starts from a selection holding all objects
+ * in the area. Only the query itself is timed.
+ *
+ * @param area The area to query.
+ * @param mode The selection mode to query with.
+ * @param objectsPerQuery Set to the number of objects each query selected or deselected.
+ * @return BenchmarkHarness::Result The cost of a single query.
+ */
+BenchmarkHarness::Result SelectionBenchmark::BenchmarkSetQuery(MultiSelector::NodeArea area,
+                                                               MultiSelector::SelectionMode mode,
+                                                               int &objectsPerQuery)
+{
+    _selector->SetSelectedNodeArea(area);
+
+    // A filter that lets everything through, like selecting all objects would.
+    std::function<bool(LevelObject *)> acceptAll = [](LevelObject *) { return true; };
+
+    SelectionSet selection;
+    BenchmarkHarness harness;
+
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        // Set up the selection the query starts from, without timing it.
+        selection.Clear();
+        if (mode == MultiSelector::eSubtract)
+        {
+            _selector->GetObjectsInArea(acceptAll, selection, MultiSelector::eAdd);
+        }
+        int countBefore = static_cast<int>(selection.GetCount());
+
+        harness.Start();
+        _selector->GetObjectsInArea(acceptAll, selection, mode);
+        harness.Stop();
+
+        objectsPerQuery = std::abs(static_cast<int>(selection.GetCount()) - countBefore);
+    }
+
+    return harness.GetResult(QUERY_COUNT);
+}
+
+/**
+ * @brief Returns an area of at most the given size in the center of a grid
+ * of the given dimensions.
+ *
+ * @param areaSize The width and height of the area, in grid nodes.
+ * @param gridDimensions The dimensions of the grid.
+ * @return MultiSelector::NodeArea The area.
+ */
+MultiSelector::NodeArea SelectionBenchmark::GetCenteredArea(int areaSize, dimension2du gridDimensions)
+{
+    int width = std::min(areaSize, static_cast<int>(gridDimensions.Width));
+    int height = std::min(areaSize, static_cast<int>(gridDimensions.Height));
+
+    MultiSelector::NodeArea area;
+    area.bottomLeft = vector2di((static_cast<int>(gridDimensions.Width) - width) / 2,
+                                (static_cast<int>(gridDimensions.Height) - height) / 2);
+    area.topRight = area.bottomLeft + vector2di(width - 1, height - 1);
+    return area;
+}
+
+/**
+ * @brief Fills the given index with stand-in objects on a random selection of nodes.
+ *
+ * @param index The index to fill. Initialized to the benchmark grid size first.
+ */
+void SelectionBenchmark::FillIndex(LevelObjectIndex &index)
+{
+    index.Initialize(dimension2du(BENCHMARK_GRID_SIZE, BENCHMARK_GRID_SIZE));
+
+    // One stand-in object per node at most, so its address never moves while indexed.
+    _standInObjects.assign(BENCHMARK_GRID_SIZE * BENCHMARK_GRID_SIZE, std::max_align_t());
+
+    std::mt19937 random(BENCHMARK_SEED);
+    std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+    int objectCount = 0;
+    for (int y = 0; y < BENCHMARK_GRID_SIZE; y++)
+    {
+        for (int x = 0; x < BENCHMARK_GRID_SIZE; x++)
+        {
+            if (chance(random) < BENCHMARK_OCCUPANCY_DENSITY)
+            {
+                // Never dereferenced, only stored and compared.
+                LevelObject *object = reinterpret_cast<LevelObject *>(&_standInObjects[objectCount++]);
+                index.OnLevelObjectPlaced(object, vector2di(x, y), LevelObjectIndex::UNIT_CATEGORY);
+            }
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @brief: Contains the SelectionBenchmark class header information.
+ * @file SelectionBenchmark.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <IUpdatable.h>
+#include <InputHandler.h>
+
+#include "MultiSelector.h"
+#include "BenchmarkHarness.h"
+
+/**
+ * @brief Benchmarks MultiSelector area queries when F10 is pressed, and prints
+ * the results to the console. Times GetObjectsInArea over small, medium and
+ * full-map rectangles, in both eAdd and eSubtract mode.
+ *
+ * The first set of queries takes the path the game takes: the list overload,
+ * with Selection::DeselectObject in eSubtract mode, on an index that was never
+ * populated, so the live Grid is scanned. The Grid is only read, but the
+ * eSubtract queries deselect every object in the area, like dragging over it
+ * would.
+ *
+ * The second set runs the SelectionSet overload on a synthetic grid of
+ * BENCHMARK_GRID_SIZE squared nodes, of which a BENCHMARK_OCCUPANCY_DENSITY
+ * fraction is occupied, kept in a LevelObjectIndex of its own.
+ *
+ * All queries use a fixed selection area, so the camera is never touched.
+ * Allocations per query are only reported when the build defines COUNT_ALLOCATIONS.
+ */
+class SelectionBenchmark : public IUpdatable, public Singleton<SelectionBenchmark>
+{
+public:
+    /**
+     * @brief Runs the benchmarks when F10 is pressed.
+     */
+    virtual void Update() override;
+
+    /**
+     * @brief Runs all benchmarks and prints the results to the console.
+     */
+    void RunAll();
+
+private:
+    /**
+     * @brief Times the list overload of GetObjectsInArea on the live Grid, over
+     * small, medium and full-map areas, and prints the results.
+     */
+    void RunGridBenchmarks();
+
+    /**
+     * @brief Times the SelectionSet overload of GetObjectsInArea on the synthetic
+     * grid, over small, medium and full-map areas, and prints the results.
+     */
+    void RunIndexBenchmarks();
+
+    /**
+     * @brief Measures a single list overload GetObjectsInArea call over the
+     * given area. In eAdd mode, every query starts from an empty list. In
+     * eSubtract mode, every query deselects the objects in the area through
+     * Selection::DeselectObject. Only the query itself is timed.
+     *
+     * @param area The area to query.
+     * @param mode The selection mode to query with.
+     * @param objectsPerQuery Set to the number of objects in the area.
+     * @return BenchmarkHarness::Result The cost of a single query.
+     */
+    BenchmarkHarness::Result BenchmarkListQuery(MultiSelector::NodeArea area,
+                                                MultiSelector::SelectionMode mode, int &objectsPerQuery);
+
+    /**
+     * @brief Measures a single SelectionSet overload GetObjectsInArea call over
+     * the given area. In eAdd mode, every query starts from an empty selection.
+     * In eSubtract mode, every query starts from a selection holding all objects
+     * in the area. Only the query itself is timed.
+     *
+     * @param area The area to query.
+     * @param mode The selection mode to query with.
+     * @param objectsPerQuery Set to the number of objects each query selected or deselected.
+     * @return BenchmarkHarness::Result The cost of a single query.
+     */
+    BenchmarkHarness::Result BenchmarkSetQuery(MultiSelector::NodeArea area,
+                                               MultiSelector::SelectionMode mode, int &objectsPerQuery);
+
+    /**
+     * @brief Returns an area of at most the given size in the center of a grid
+     * of the given dimensions.
+     *
+     * @param areaSize The width and height of the area, in grid nodes.
+     * @param gridDimensions The dimensions of the grid.
+     * @return MultiSelector::NodeArea The area.
+     */
+    MultiSelector::NodeArea GetCenteredArea(int areaSize, dimension2du gridDimensions);
+
+    /**
+     * @brief Fills the given index with stand-in objects on a random selection of nodes.
+     *
+     * @param index The index to fill. Initialized to the benchmark grid size first.
+     */
+    void FillIndex(LevelObjectIndex &index);
+
+    // The index the synthetic grid is kept in. Only filled while the index
+    // benchmarks run, so the Grid benchmarks find it unpopulated.
+    LevelObjectIndex _index;
+
+    // The selector all benchmarks query through _index. Created on the first
+    // run and kept, so its scene node isn't created and removed every run.
+    std::unique_ptr<MultiSelector> _selector;
+
+    // The memory the stand-in objects point into. The index and selections
+    // only store and compare object pointers, so no actual LevelObjects, and
+    // none of their scene nodes, are needed.
+    std::vector<std::max_align_t> _standInObjects;
+};
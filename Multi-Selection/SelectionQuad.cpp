@@ -0,0 +1,154 @@
+/**
+ * @brief: Contains the SelectionQuad class function implementations.
+ * @file SelectionQuad.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "SelectionQuad.h"
+
+#include <algorithm>
+
+#if SELECTION_QUAD_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Sets the corners of the quad, in either winding order.
+ * Only the X and Z of the corners are used.
+ * 
+ * @param corners The 4 corners of the quad, in order around the quad.
+ */
+void SelectionQuad::SetCorners(const vector3df corners[4])
+{
+    // Get twice the signed area, to tell the winding order.
+    float doubleArea = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        const vector3df &corner = corners[i];
+        const vector3df &nextCorner = corners[(i + 1) % 4];
+        doubleArea += corner.X * nextCorner.Z - nextCorner.X * corner.Z;
+    }
+
+    // Store the corners counterclockwise, so every inside point lies to the
+    // left of every edge.
+    for (int i = 0; i < 4; i++)
+    {
+        const vector3df &corner = doubleArea >= 0 ? corners[i] : corners[3 - i];
+        _cornerX[i] = corner.X;
+        _cornerZ[i] = corner.Z;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        _edgeX[i] = _cornerX[(i + 1) % 4] - _cornerX[i];
+        _edgeZ[i] = _cornerZ[(i + 1) % 4] - _cornerZ[i];
+    }
+}
+
+/**
+ * @brief Returns the corner with the given index, in counterclockwise order.
+ */
+vector3df SelectionQuad::GetCorner(int index) const
+{
+    return vector3df(_cornerX[index], 0, _cornerZ[index]);
+}
+
+/**
+ * @brief Returns the axis-aligned bounds of the quad on the ground.
+ * 
+ * @param minimum Set to the minimum X and Z of the quad.
+ * @param maximum Set to the maximum X and Z of the quad.
+ */
+void SelectionQuad::GetBounds(vector3df &minimum, vector3df &maximum) const
+{
+    minimum = vector3df(*std::min_element(_cornerX, _cornerX + 4), 0,
+                        *std::min_element(_cornerZ, _cornerZ + 4));
+    maximum = vector3df(*std::max_element(_cornerX, _cornerX + 4), 0,
+                        *std::max_element(_cornerZ, _cornerZ + 4));
+}
+
+/**
+ * @brief Returns whether the given point on the ground lies inside the quad.
+ * Points on the edges count as inside.
+ */
+bool SelectionQuad::Contains(float x, float z) const
+{
+    // The point is inside if it lies to the left of, or on, every edge.
+    for (int i = 0; i < 4; i++)
+    {
+        float cross = _edgeX[i] * (z - _cornerZ[i]) - _edgeZ[i] * (x - _cornerX[i]);
+        if (cross < 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Tests the given points against the quad, and stores the indices of
+ * the points inside it.
+ * 
+ * @param x The X coordinates of the points.
+ * @param z The Z coordinates of the points.
+ * @param count The number of points.
+ * @param insideIndices Filled with the indices of the points inside the quad,
+ * in increasing order. Must have room for count indices.
+ * @return int The number of points inside the quad.
+ */
+int SelectionQuad::GetPointsInside(const float *x, const float *z, int count, int *insideIndices) const
+{
+    int insideCount = 0;
+    int i = 0;
+
+#if SELECTION_QUAD_USE_SSE2
+    // Broadcast the corners and edges once, outside of the loop.
+    __m128 cornerX[4], cornerZ[4], edgeX[4], edgeZ[4];
+    for (int edge = 0; edge < 4; edge++)
+    {
+        cornerX[edge] = _mm_set1_ps(_cornerX[edge]);
+        cornerZ[edge] = _mm_set1_ps(_cornerZ[edge]);
+        edgeX[edge] = _mm_set1_ps(_edgeX[edge]);
+        edgeZ[edge] = _mm_set1_ps(_edgeZ[edge]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    // Test 4 points at a time against all 4 edges.
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 pointX = _mm_loadu_ps(x + i);
+        __m128 pointZ = _mm_loadu_ps(z + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (int edge = 0; edge < 4; edge++)
+        {
+            __m128 cross = _mm_sub_ps(_mm_mul_ps(edgeX[edge], _mm_sub_ps(pointZ, cornerZ[edge])),
+                                      _mm_mul_ps(edgeZ[edge], _mm_sub_ps(pointX, cornerX[edge])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(cross, zero));
+        }
+
+        // Store the indices of the points whose bit is set.
+        int insideMask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            if (insideMask & (1 << lane))
+            {
+                insideIndices[insideCount++] = i + lane;
+            }
+        }
+    }
+#endif
+
+    // Test the remaining points one by one.
+    for (; i < count; i++)
+    {
+        if (Contains(x[i], z[i]))
+        {
+            insideIndices[insideCount++] = i;
+        }
+    }
+
+    return insideCount;
+}
@@ -0,0 +1,78 @@
+/**
+ * @brief: Contains the SelectionQuad class header information.
+ * @file SelectionQuad.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <irrlicht.h>
+
+// Whether to test points against the quad 4 at a time with SSE2 instructions.
+// Falls back to testing points one by one on platforms without SSE2.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SELECTION_QUAD_USE_SSE2 true
+#else
+#define SELECTION_QUAD_USE_SSE2 false
+#endif
+
+using irr::core::vector3df;
+
+/**
+ * @brief: A convex quadrilateral on the ground (the XZ plane), such as the
+ * projection of the screen-space selection rectangle through a tilted camera.
+ * Tests many points against the quad at once, 4 per batch when SSE2 is available.
+ */
+class SelectionQuad
+{
+public:
+    /**
+     * @brief Sets the corners of the quad, in either winding order.
+     * Only the X and Z of the corners are used.
+     * 
+     * @param corners The 4 corners of the quad, in order around the quad.
+     */
+    void SetCorners(const vector3df corners[4]);
+
+    /**
+     * @brief Returns the corner with the given index, in counterclockwise order.
+     */
+    vector3df GetCorner(int index) const;
+
+    /**
+     * @brief Returns the axis-aligned bounds of the quad on the ground.
+     * 
+     * @param minimum Set to the minimum X and Z of the quad.
+     * @param maximum Set to the maximum X and Z of the quad.
+     */
+    void GetBounds(vector3df &minimum, vector3df &maximum) const;
+
+    /**
+     * @brief Returns whether the given point on the ground lies inside the quad.
+     * Points on the edges count as inside.
+     */
+    bool Contains(float x, float z) const;
+
+    /**
+     * @brief Tests the given points against the quad, and stores the indices of
+     * the points inside it.
+     * 
+     * @param x The X coordinates of the points.
+     * @param z The Z coordinates of the points.
+     * @param count The number of points.
+     * @param insideIndices Filled with the indices of the points inside the quad,
+     * in increasing order. Must have room for count indices.
+     * @return int The number of points inside the quad.
+     */
+    int GetPointsInside(const float *x, const float *z, int count, int *insideIndices) const;
+
+private:
+    // The corners in counterclockwise order, seen from above.
+    float _cornerX[4] = {};
+    float _cornerZ[4] = {};
+
+    // The edge from every corner to the next one.
+    float _edgeX[4] = {};
+    float _edgeZ[4] = {};
+};
@@ -0,0 +1,209 @@
+/**
+ * @brief: Contains the SelectionRectangleSceneNode class function implementations.
+ * @file SelectionRectangleSceneNode.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "SelectionRectangleSceneNode.h"
+
+#include <algorithm>
+#include <cmath>
+
+SelectionRectangleSceneNode::SelectionRectangleSceneNode(ISceneNode *parent,
+                                                         ISceneManager *sceneManager,
+                                                         SColor outlineColor,
+                                                         SColor fillColor)
+    : ISceneNode(parent, sceneManager)
+{
+    _outlineColor = outlineColor;
+    _fillColor = fillColor;
+
+    // Unlit, so the colors show as they are, and blended by vertex alpha, so
+    // the fill can be translucent while the outline stays opaque.
+    _material.Lighting = false;
+    _material.BackfaceCulling = false;
+    _material.MaterialType = irr::video::EMT_TRANSPARENT_VERTEX_ALPHA;
+
+    // Every quad is made of 2 triangles over its 4 corners, and never changes.
+    for (int quad = 0; quad < FILL_TRIANGLE_COUNT / 2 + OUTLINE_TRIANGLE_COUNT / 2; quad++)
+    {
+        irr::u16 *indices = &_indices[quad * 6];
+        irr::u16 firstVertex = static_cast<irr::u16>(quad * 4);
+
+        indices[0] = firstVertex;
+        indices[1] = firstVertex + 1;
+        indices[2] = firstVertex + 2;
+        indices[3] = firstVertex;
+        indices[4] = firstVertex + 2;
+        indices[5] = firstVertex + 3;
+    }
+}
+
+/**
+ * @brief Sets the rectangle to draw. Does nothing if the rectangle didn't change.
+ * 
+ * @param bottomLeftCorner The bottom left corner of the rectangle. Its Y is
+ * the height the rectangle is drawn at.
+ * @param width The size of the rectangle along the X axis.
+ * @param height The size of the rectangle along the Z axis.
+ * @param thickness The width of the outline, centered on the rectangle's edges.
+ */
+void SelectionRectangleSceneNode::SetRectangle(vector3df bottomLeftCorner, float width,
+                                               float height, float thickness)
+{
+    vector3df corners[4] =
+    {
+        bottomLeftCorner,
+        vector3df(bottomLeftCorner.X, bottomLeftCorner.Y, bottomLeftCorner.Z + height),
+        vector3df(bottomLeftCorner.X + width, bottomLeftCorner.Y, bottomLeftCorner.Z + height),
+        vector3df(bottomLeftCorner.X + width, bottomLeftCorner.Y, bottomLeftCorner.Z)
+    };
+
+    SetCorners(corners, thickness);
+}
+
+/**
+ * @brief Sets the quad to draw, for selections that aren't axis aligned.
+ * Does nothing if the quad didn't change.
+ * 
+ * @param corners The 4 corners of the quad, in order around the quad.
+ * @param thickness The width of the outline, centered on the quad's edges.
+ */
+void SelectionRectangleSceneNode::SetCorners(const vector3df corners[4], float thickness)
+{
+    // Skip rewriting the vertices if nothing changed since the last frame.
+    if (std::equal(corners, corners + 4, _corners) && thickness == _thickness)
+    {
+        return;
+    }
+
+    std::copy(corners, corners + 4, _corners);
+    _thickness = thickness;
+
+    // Fill quad, covering the inside of the quad.
+    SetQuad(&_vertices[0], corners, _fillColor);
+
+    // Outline quads along every edge, slightly above the fill so they always
+    // win the depth test.
+    S3DVertex *outline = &_vertices[FILL_VERTEX_COUNT];
+    vector3df outlineOffset(0, 0.01f, 0);
+    for (int i = 0; i < 4; i++)
+    {
+        SetLine(&outline[i * 4], corners[i] + outlineOffset, corners[(i + 1) % 4] + outlineOffset,
+                thickness, _outlineColor);
+    }
+
+    // Fit the bounding box around the outline, so the node is culled correctly.
+    float halfThickness = thickness / 2.f;
+    _boundingBox.reset(corners[0]);
+    for (int i = 0; i < 4; i++)
+    {
+        _boundingBox.addInternalPoint(corners[i] - vector3df(halfThickness, 0, halfThickness));
+        _boundingBox.addInternalPoint(corners[i] + outlineOffset + vector3df(halfThickness, 0, halfThickness));
+    }
+}
+
+/**
+ * @brief Sets whether the inside of the rectangle is filled.
+ */
+void SelectionRectangleSceneNode::SetFillVisible(bool fillVisible)
+{
+    _fillVisible = fillVisible;
+}
+
+void SelectionRectangleSceneNode::OnRegisterSceneNode()
+{
+    if (isVisible())
+    {
+        // Draw in the transparent pass, after the ground it lies on.
+        SceneManager->registerNodeForRendering(this, irr::scene::ESNRP_TRANSPARENT);
+    }
+
+    ISceneNode::OnRegisterSceneNode();
+}
+
+void SelectionRectangleSceneNode::render()
+{
+    irr::video::IVideoDriver *driver = SceneManager->getVideoDriver();
+
+    driver->setMaterial(_material);
+    driver->setTransform(irr::video::ETS_WORLD, getAbsoluteTransformation());
+
+    // Skip the triangles of the fill quad at the start of the indices if it's hidden.
+    int firstIndex = _fillVisible ? 0 : FILL_TRIANGLE_COUNT * 3;
+    int triangleCount = OUTLINE_TRIANGLE_COUNT + (_fillVisible ? FILL_TRIANGLE_COUNT : 0);
+
+    // Draw the outline and the fill in a single call.
+    driver->drawVertexPrimitiveList(_vertices,
+                                    FILL_VERTEX_COUNT + OUTLINE_VERTEX_COUNT,
+                                    &_indices[firstIndex],
+                                    triangleCount,
+                                    irr::video::EVT_STANDARD,
+                                    irr::scene::EPT_TRIANGLES,
+                                    irr::video::EIT_16BIT);
+}
+
+const aabbox3df &SelectionRectangleSceneNode::getBoundingBox() const
+{
+    return _boundingBox;
+}
+
+irr::u32 SelectionRectangleSceneNode::getMaterialCount() const
+{
+    return 1;
+}
+
+SMaterial &SelectionRectangleSceneNode::getMaterial(irr::u32 i)
+{
+    return _material;
+}
+
+/**
+ * @brief Writes the given 4 corners of a quad to the given vertices.
+ */
+void SelectionRectangleSceneNode::SetQuad(S3DVertex *vertices, const vector3df corners[4], SColor color)
+{
+    // All quads lie flat on the ground, facing up.
+    vertices[0] = S3DVertex(corners[0].X, corners[0].Y, corners[0].Z, 0, 1, 0, color, 0, 0);
+    vertices[1] = S3DVertex(corners[1].X, corners[1].Y, corners[1].Z, 0, 1, 0, color, 0, 1);
+    vertices[2] = S3DVertex(corners[2].X, corners[2].Y, corners[2].Z, 0, 1, 0, color, 1, 1);
+    vertices[3] = S3DVertex(corners[3].X, corners[3].Y, corners[3].Z, 0, 1, 0, color, 1, 0);
+}
+
+/**
+ * @brief Writes a line quad from the start to the end point to the given
+ * vertices, extended by half the thickness at both ends so lines meet at corners.
+ */
+void SelectionRectangleSceneNode::SetLine(S3DVertex *vertices, vector3df start, vector3df end,
+                                          float thickness, SColor color)
+{
+    float halfThickness = thickness / 2.f;
+
+    // Get the direction of the line on the ground, and the direction across it.
+    float directionX = end.X - start.X;
+    float directionZ = end.Z - start.Z;
+    float length = std::sqrt(directionX * directionX + directionZ * directionZ);
+    if (length > 0)
+    {
+        directionX /= length;
+        directionZ /= length;
+    }
+    else
+    {
+        directionX = 1;
+    }
+
+    vector3df along(directionX * halfThickness, 0, directionZ * halfThickness);
+    vector3df across(-directionZ * halfThickness, 0, directionX * halfThickness);
+
+    vector3df corners[4] =
+    {
+        start - along - across,
+        start - along + across,
+        end + along + across,
+        end + along - across
+    };
+
+    SetQuad(vertices, corners, color);
+}
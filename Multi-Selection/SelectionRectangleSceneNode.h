@@ -0,0 +1,105 @@
+/**
+ * @brief: Contains the SelectionRectangleSceneNode class header information.
+ * @file SelectionRectangleSceneNode.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <irrlicht.h>
+
+using irr::core::aabbox3df;
+using irr::core::vector3df;
+using irr::scene::ISceneManager;
+using irr::scene::ISceneNode;
+using irr::video::S3DVertex;
+using irr::video::SColor;
+using irr::video::SMaterial;
+
+/**
+ * @brief: Scene node that draws the outline of a selection rectangle on the
+ * ground, with an optional translucent fill, as a single mesh in a single draw
+ * call. The vertices are only rewritten when the rectangle actually changes.
+ */
+class SelectionRectangleSceneNode : public ISceneNode
+{
+public:
+    /**
+     * @brief Creates the scene node under the given parent.
+     * 
+     * @param parent The parent scene node.
+     * @param sceneManager The scene manager the node belongs to.
+     * @param outlineColor The color of the outline.
+     * @param fillColor The color of the fill. Use a low alpha for a translucent fill.
+     */
+    SelectionRectangleSceneNode(ISceneNode *parent, ISceneManager *sceneManager,
+                                SColor outlineColor, SColor fillColor);
+
+    /**
+     * @brief Sets the rectangle to draw. Does nothing if the rectangle didn't change.
+     * 
+     * @param bottomLeftCorner The bottom left corner of the rectangle. Its Y is
+     * the height the rectangle is drawn at.
+     * @param width The size of the rectangle along the X axis.
+     * @param height The size of the rectangle along the Z axis.
+     * @param thickness The width of the outline, centered on the rectangle's edges.
+     */
+    void SetRectangle(vector3df bottomLeftCorner, float width, float height, float thickness);
+
+    /**
+     * @brief Sets the quad to draw, for selections that aren't axis aligned.
+     * Does nothing if the quad didn't change.
+     * 
+     * @param corners The 4 corners of the quad, in order around the quad.
+     * @param thickness The width of the outline, centered on the quad's edges.
+     */
+    void SetCorners(const vector3df corners[4], float thickness);
+
+    /**
+     * @brief Sets whether the inside of the rectangle is filled.
+     */
+    void SetFillVisible(bool fillVisible);
+
+    virtual void OnRegisterSceneNode() override;
+    virtual void render() override;
+    virtual const aabbox3df &getBoundingBox() const override;
+    virtual irr::u32 getMaterialCount() const override;
+    virtual SMaterial &getMaterial(irr::u32 i) override;
+
+private:
+    // Number of vertices and triangles of the 4 outline quads.
+    static const int OUTLINE_VERTEX_COUNT = 16;
+    static const int OUTLINE_TRIANGLE_COUNT = 8;
+
+    // Number of vertices and triangles of the fill quad.
+    static const int FILL_VERTEX_COUNT = 4;
+    static const int FILL_TRIANGLE_COUNT = 2;
+
+    /**
+     * @brief Writes the given 4 corners of a quad to the given vertices.
+     */
+    static void SetQuad(S3DVertex *vertices, const vector3df corners[4], SColor color);
+
+    /**
+     * @brief Writes a line quad from the start to the end point to the given
+     * vertices, extended by half the thickness at both ends so lines meet at corners.
+     */
+    static void SetLine(S3DVertex *vertices, vector3df start, vector3df end,
+                        float thickness, SColor color);
+
+    // The fill quad first, then the outline quads, so the outline is drawn on top.
+    S3DVertex _vertices[FILL_VERTEX_COUNT + OUTLINE_VERTEX_COUNT];
+    irr::u16 _indices[(FILL_TRIANGLE_COUNT + OUTLINE_TRIANGLE_COUNT) * 3];
+
+    // The quad the vertices were last written for.
+    vector3df _corners[4];
+    float _thickness = -1;
+
+    SColor _outlineColor;
+    SColor _fillColor;
+    bool _fillVisible = false;
+
+    SMaterial _material;
+    aabbox3df _boundingBox;
+};
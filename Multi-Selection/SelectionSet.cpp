@@ -0,0 +1,133 @@
+/**
+ * @brief: Contains the SelectionSet class function implementations.
+ * @file SelectionSet.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "SelectionSet.h"
+
+/**
+ * @brief Adds the given object, unless it's already in the set.
+ * 
+ * @param object The object to add.
+ * @return bool Whether the object was added.
+ */
+bool SelectionSet::Add(LevelObject *object)
+{
+    // Null marks a hole in the ordered list, so it can't be added.
+    if (!object)
+    {
+        return false;
+    }
+
+    // Only add the object if it wasn't in the set yet.
+    if (!_positions.emplace(object, _objects.size()).second)
+    {
+        return false;
+    }
+
+    _objects.push_back(object);
+    return true;
+}
+
+/**
+ * @brief Removes the given object, if it's in the set.
+ * 
+ * @param object The object to remove.
+ * @return bool Whether the object was removed.
+ */
+bool SelectionSet::Remove(LevelObject *object)
+{
+    auto position = _positions.find(object);
+    if (position == _positions.end())
+    {
+        return false;
+    }
+
+    // Leave a hole instead of shifting all objects behind it.
+    _objects[position->second] = nullptr;
+    _positions.erase(position);
+    _holeCount++;
+
+    // Don't let holes take over the list.
+    if (_holeCount * 2 > _objects.size())
+    {
+        Compact();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns whether the given object is in the set.
+ */
+bool SelectionSet::Contains(LevelObject *object) const
+{
+    return _positions.count(object) > 0;
+}
+
+/**
+ * @brief Removes all objects from the set.
+ */
+void SelectionSet::Clear()
+{
+    _objects.clear();
+    _positions.clear();
+    _holeCount = 0;
+}
+
+/**
+ * @brief Makes room for the given number of objects, so adding them won't grow
+ * the ordered list or rehash the set. Each added object still allocates a
+ * node in the set.
+ */
+void SelectionSet::Reserve(std::size_t objectCount)
+{
+    _objects.reserve(objectCount);
+    _positions.reserve(objectCount);
+}
+
+/**
+ * @brief Returns the number of objects in the set.
+ */
+std::size_t SelectionSet::GetCount() const
+{
+    return _positions.size();
+}
+
+/**
+ * @brief Returns the objects in the set, in the order they were added.
+ * 
+ * @return const std::vector<LevelObject *>& The objects in the set.
+ */
+const std::vector<LevelObject *> &SelectionSet::GetObjects()
+{
+    if (_holeCount > 0)
+    {
+        Compact();
+    }
+
+    return _objects;
+}
+
+/**
+ * @brief Removes all holes from the ordered list, keeping the order.
+ */
+void SelectionSet::Compact()
+{
+    std::size_t count = 0;
+
+    // Move every object back to close the holes in front of it.
+    for (LevelObject *object : _objects)
+    {
+        if (object)
+        {
+            _positions[object] = count;
+            _objects[count++] = object;
+        }
+    }
+
+    _objects.resize(count);
+    _holeCount = 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @brief: Contains the SelectionSet class header information.
+ * @file SelectionSet.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <LevelObject.h>
+
+/**
+ * @brief: A set of selected LevelObjects with constant time add, remove and
+ * membership tests, that iterates in the order the objects were added.
+ *
+ * Removing an object only leaves a hole in the ordered list. Holes are
+ * compacted in a single pass the next time the list is read, or once they make
+ * up half of the list, so removing many objects at once stays linear.
+ */
+class SelectionSet
+{
+public:
+    /**
+     * @brief Adds the given object, unless it's already in the set.
+     * 
+     * @param object The object to add.
+     * @return bool Whether the object was added.
+     */
+    bool Add(LevelObject *object);
+
+    /**
+     * @brief Removes the given object, if it's in the set.
+     * 
+     * @param object The object to remove.
+     * @return bool Whether the object was removed.
+     */
+    bool Remove(LevelObject *object);
+
+    /**
+     * @brief Returns whether the given object is in the set.
+     */
+    bool Contains(LevelObject *object) const;
+
+    /**
+     * @brief Adds all objects in the given range that aren't in the set yet.
+     * 
+     * @param begin Iterator to the first object to add.
+     * @param end Iterator past the last object to add.
+     */
+    template <typename Iterator>
+    void AddRange(Iterator begin, Iterator end)
+    {
+        for (; begin != end; ++begin)
+        {
+            Add(*begin);
+        }
+    }
+
+    /**
+     * @brief Removes all objects in the given range that are in the set.
+     * 
+     * @param begin Iterator to the first object to remove.
+     * @param end Iterator past the last object to remove.
+     */
+    template <typename Iterator>
+    void SubtractRange(Iterator begin, Iterator end)
+    {
+        for (; begin != end; ++begin)
+        {
+            Remove(*begin);
+        }
+    }
+
+    /**
+     * @brief Removes all objects from the set.
+     */
+    void Clear();
+
+    /**
+     * @brief Makes room for the given number of objects, so adding them won't grow
+     * the ordered list or rehash the set. Each added object still allocates a
+     * node in the set.
+     */
+    void Reserve(std::size_t objectCount);
+
+    /**
+     * @brief Returns the number of objects in the set.
+     */
+    std::size_t GetCount() const;
+
+    /**
+     * @brief Returns the objects in the set, in the order they were added.
+     * 
+     * @return const std::vector<LevelObject *>& The objects in the set.
+     */
+    const std::vector<LevelObject *> &GetObjects();
+
+private:
+    /**
+     * @brief Removes all holes from the ordered list, keeping the order.
+     */
+    void Compact();
+
+    // The objects in the order they were added. Removed objects leave a nullptr.
+    std::vector<LevelObject *> _objects;
+
+    // The position of every object in _objects.
+    std::unordered_map<LevelObject *, std::size_t> _positions;
+
+    // The number of nullptrs in _objects.
+    std::size_t _holeCount = 0;
+};
@@ -7,10 +7,18 @@
 
 #include "LevelGenDebugger.h"
 
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
 // How fast the camera zooms in and out.
 #define CAMERA_ZOOM_SPEED 300
 // Whether to print the grid to the console.
 #define PRINT_GRID_TO_CONSOLE true
+// The minimum distance between points in the poisson disc benchmark.
+#define BENCHMARK_MINIMUM_DISTANCE 6
+// How many times the poisson disc benchmark generates points per map size.
+#define BENCHMARK_RUN_COUNT 5
 
 /**
  * @brief: Initializes level gen debugging settings.
@@ -71,4 +79,52 @@ void LevelGenDebugger::Update()
         // Generate a new level.
         LevelGenerator::GenerateLevel();
     }
+
+    // Benchmark poisson disc point generation when F11 is pressed.
+    if (InputHandler::GetInstance()->IsKeyPressed(irr::KEY_F11))
+    {
+        BenchmarkPoissonDisc();
+    }
+}
+
+/**
+ * @brief: Times point generation on increasingly large maps and prints the
+ * results to the console. The time per generated point should stay about
+ * the same for every map size, since generation is linear in the number
+ * of generated points.
+ */
+void LevelGenDebugger::BenchmarkPoissonDisc()
+{
+    printf("PoissonDisc benchmark, minimum distance %d\n", BENCHMARK_MINIMUM_DISTANCE);
+
+    // Measure every sampling algorithm on the same map sizes.
+    const PoissonDisc::SamplingAlgorithm algorithms[] = {PoissonDisc::eQueue, PoissonDisc::eBridson};
+    const char *algorithmNames[] = {"eQueue", "eBridson"};
+
+    for (int algorithm = 0; algorithm < 2; algorithm++)
+    {
+        // Double the map size every step, so the number of points quadruples.
+        for (unsigned int mapSize = 128; mapSize <= 2048; mapSize *= 2)
+        {
+            long long pointCount = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+
+            for (int run = 0; run < BENCHMARK_RUN_COUNT; run++)
+            {
+                ListOfPoints points = PoissonDisc::GeneratePoints(BENCHMARK_MINIMUM_DISTANCE,
+                                                                  dimension2du(mapSize, mapSize),
+                                                                  {}, {}, std::numeric_limits<int>::max(),
+                                                                  algorithms[algorithm]);
+                pointCount += points.size();
+            }
+
+            auto end = std::chrono::high_resolution_clock::now();
+            double milliseconds = std::chrono::duration<double, std::milli>(end - start).count() / BENCHMARK_RUN_COUNT;
+            double pointsPerRun = static_cast<double>(pointCount) / BENCHMARK_RUN_COUNT;
+
+            printf("  %-8s %4ux%-4u %10.0f points %10.2f ms %8.1f ns/point\n",
+                   algorithmNames[algorithm], mapSize, mapSize, pointsPerRun, milliseconds,
+                   pointsPerRun > 0 ? milliseconds * 1e6 / pointsPerRun : 0.0);
+        }
+    }
 }
@@ -35,6 +35,14 @@ public:
     virtual void Update() override;
 
 private:
+    /**
+     * @brief: Times point generation on increasingly large maps and prints the
+     * results to the console. The time per generated point should stay about
+     * the same for every map size, since generation is linear in the number
+     * of generated points.
+     */
+    void BenchmarkPoissonDisc();
+
     /**
      * @brief: A pointer to the camera.
      * We need this in order to zoom the camera.
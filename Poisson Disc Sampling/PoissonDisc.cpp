@@ -7,9 +7,8 @@
 
 #include "PoissonDisc.h"
 
-// The amount of new points generated for every processed point.
-// Higher values lead to points being grouped closer together.
-#define POINTS_PER_LOOP 30
+#include <algorithm>
+#include <cstdlib>
 
 /**
  * @brief: Generates a uniformly distributed list of 2D point coordinates,
@@ -25,13 +24,18 @@
  * @param maxNumberOfPoints: Max number of points to generate. If this parameter
  * is passed in, points will only be generated around the first point in the
  * existingPoints list.
+ * @param algorithm: The order in which points are processed.
+ * @param attemptsPerPoint: The amount of new points tried around every
+ * processed point. Higher values lead to points being grouped closer together.
  * @return ListOfPoints: The uniformly distributed list of points.
  */
 ListOfPoints PoissonDisc::GeneratePoints(int minimumDistance,
                                          dimension2du mapDimensions,
                                          const std::vector<MapSection> &excludedSections,
                                          const std::vector<vector2di> &existingPoints,
-                                         const int maxNumberOfPoints)
+                                         const int maxNumberOfPoints,
+                                         SamplingAlgorithm algorithm,
+                                         int attemptsPerPoint)
 {
     // ** INITIALIZATION ** //
     // The final list of evenly distributed points (vector2di values).
@@ -53,15 +57,11 @@ ListOfPoints PoissonDisc::GeneratePoints(int minimumDistance,
     // Initialize the dimensions of the point grid.
     pointGrid.dimensions = dimension2du(pointGridWidth, pointGridHeight);
 
-    // Initialize the point grid with empty rows.
-    for (int i = 0; i < pointGridHeight; i++)
-    {
-        // Initialize point grid row with a vector2di list, with grid width as size.
-        // Initialize all points in the row to default value (-1, -1) to be able to check
-        // for unset tiles later. Chosen value is (-1, -1), because a point could never
-        // normally be generated at this position, as it is outside the bounds of the point grid.
-        pointGrid.grid.push_back(ListOfPoints(pointGridWidth, vector2di(-1, -1)));
-    }
+    // Initialize all tiles of the point grid in a single allocation.
+    // Initialize all points to default value (-1, -1) to be able to check
+    // for unset tiles later. Chosen value is (-1, -1), because a point could never
+    // normally be generated at this position, as it is outside the bounds of the point grid.
+    pointGrid.tiles.assign(pointGridWidth * pointGridHeight, vector2di(-1, -1));
     
     // Check if any existing points were passed in.
     if(existingPoints.empty())
@@ -82,7 +82,7 @@ ListOfPoints PoissonDisc::GeneratePoints(int minimumDistance,
         // Get grid tile corresponding to first point.
         vector2di gridTile = PointToGridTile(firstPoint, pointGridCellSize);
         // Add first point to its corresponding tile in the point grid.
-        pointGrid.grid[gridTile.X][gridTile.Y] = firstPoint;
+        pointGrid.At(gridTile) = firstPoint;
     }
     else
     {
@@ -102,7 +102,7 @@ ListOfPoints PoissonDisc::GeneratePoints(int minimumDistance,
             // Get grid tile corresponding to new point.
             vector2di gridTile = PointToGridTile(point, pointGridCellSize);
             // Add new point to its corresponding tile in the point grid.
-            pointGrid.grid[gridTile.X][gridTile.Y] = point;
+            pointGrid.At(gridTile) = point;
         }
     }
 
@@ -110,45 +110,91 @@ ListOfPoints PoissonDisc::GeneratePoints(int minimumDistance,
     int numberOfPoints = 0;
 
     // ** GENERATE ALL SAMPLE POINTS ** //
-    // Generate the rest of the points by processing them all untill there's no
-    // more points left to process, starting with the first generated point.
-    while (!processQueue.empty() && numberOfPoints < maxNumberOfPoints)
+    if (algorithm == eBridson)
     {
-        // The point currently being processed.
-        vector2di currentPoint = processQueue.front();
-
-        // Generate a set number of points around the current point.
-        for (int i = 0; i < POINTS_PER_LOOP; i++)
+        // Move the points to process into an active list, to pick from at random.
+        ListOfPoints activeList;
+        while (!processQueue.empty())
         {
-            // Generate a randomly placed new point around current point.
-            vector2di newPoint = GenerateRandomPointAroundPoint(currentPoint, minimumDistance);
+            activeList.push_back(processQueue.front());
+            processQueue.pop();
+        }
 
-            // Make sure the point is within the bounds of the map and not too close
-            // to any previously generated points.
-            if (InsideRectangle(newPoint, vector2di(0), mapDimensions) &&
-                !InNeighborhood(newPoint, minimumDistance, pointGrid, pointGridCellSize))
+        // Keep processing random active points untill none are left.
+        while (!activeList.empty() && numberOfPoints < maxNumberOfPoints)
+        {
+            // Pick a random point from the active list.
+            int activeIndex = std::min(static_cast<int>(CustomRandom::Range(0.f, 1.f) * activeList.size()),
+                                       static_cast<int>(activeList.size()) - 1);
+            vector2di currentPoint = activeList[activeIndex];
+
+            // Try to place a new point around the current point, and keep the
+            // current point active for as long as that keeps succeeding.
+            bool placedPoint = false;
+            for (int i = 0; i < attemptsPerPoint; i++)
             {
-                // Point was inside map and not too close to any existing points.
-                // Add new point to process queue, output list and grid.
-                processQueue.push(newPoint);
-                outputList.push_back(newPoint);
-                // Get grid tile corresponding to new point.
-                vector2di gridTile = PointToGridTile(newPoint, pointGridCellSize);
-                // Add new point to its corresponding tile in the point grid.
-                pointGrid.grid[gridTile.X][gridTile.Y] = newPoint;
-
-                numberOfPoints++;
-                if (maxNumberOfPoints < MAX_INT)
+                // Generate a randomly placed new point around current point.
+                vector2di newPoint = GenerateRandomPointAroundPoint(currentPoint, minimumDistance);
+
+                if (TryPlacePoint(newPoint, minimumDistance, mapDimensions, pointGrid, pointGridCellSize))
                 {
+                    // Add new point to active list and output list.
+                    activeList.push_back(newPoint);
+                    outputList.push_back(newPoint);
+
+                    numberOfPoints++;
+                    placedPoint = true;
                     break;
                 }
             }
-        }
 
-        if (!maxNumberOfPoints < MAX_INT)
+            if (!placedPoint)
+            {
+                // Every attempt failed, so the area around the current point is
+                // full. Retire the point by swapping it with the last active
+                // point and popping, since the order doesn't matter.
+                activeList[activeIndex] = activeList.back();
+                activeList.pop_back();
+            }
+        }
+    }
+    else
+    {
+        // Generate the rest of the points by processing them all untill there's no
+        // more points left to process, starting with the first generated point.
+        while (!processQueue.empty() && numberOfPoints < maxNumberOfPoints)
         {
-            // Pop the processed point from the process queue.
-            processQueue.pop();
+            // The point currently being processed.
+            vector2di currentPoint = processQueue.front();
+
+            // Generate a set number of points around the current point.
+            for (int i = 0; i < attemptsPerPoint; i++)
+            {
+                // Generate a randomly placed new point around current point.
+                vector2di newPoint = GenerateRandomPointAroundPoint(currentPoint, minimumDistance);
+
+                // Make sure the point is within the bounds of the map and not too close
+                // to any previously generated points.
+                if (TryPlacePoint(newPoint, minimumDistance, mapDimensions, pointGrid, pointGridCellSize))
+                {
+                    // Point was inside map and not too close to any existing points.
+                    // Add new point to process queue and output list.
+                    processQueue.push(newPoint);
+                    outputList.push_back(newPoint);
+
+                    numberOfPoints++;
+                    if (maxNumberOfPoints < MAX_INT)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if (!maxNumberOfPoints < MAX_INT)
+            {
+                // Pop the processed point from the process queue.
+                processQueue.pop();
+            }
         }
     }
 
@@ -224,9 +270,38 @@ bool PoissonDisc::InsideRectangle(vector2di point,
            point.Y >= offset.Y && point.Y < offset.Y + dimensions.Height;
 }
 
+/**
+ * @brief: Places the given point on the point grid, if it is within the bounds
+ * of the map and not too close to any previously placed points.
+ * 
+ * @param point: The point to place.
+ * @param minimumDistance: The minimum distance between points.
+ * @param mapDimensions: The dimensions of the map the point must be on.
+ * @param pointGrid: The grid to place the point on.
+ * @param cellSize: The cell size of the point grid.
+ * @return bool: Whether the point was placed.
+ */
+bool PoissonDisc::TryPlacePoint(vector2di point,
+                                int minimumDistance,
+                                dimension2du mapDimensions,
+                                PointGrid2D &pointGrid,
+                                float cellSize)
+{
+    if (!InsideRectangle(point, vector2di(0), mapDimensions) ||
+        InNeighborhood(point, minimumDistance, pointGrid, cellSize))
+    {
+        return false;
+    }
+
+    // Add the point to its corresponding tile in the point grid.
+    pointGrid.At(PointToGridTile(point, cellSize)) = point;
+    return true;
+}
+
 /**
  * @brief: Returns whether a point is already present on the grid that is
  * less than the minimum distance between points away from the given point.
+ * Checks the tiles around the point directly on the grid, without copying anything.
  * 
  * @param centerPoint: The point to check for close neighbors for.
  * @param minimumDistance: The minimum distance between points.
@@ -237,89 +312,55 @@ bool PoissonDisc::InsideRectangle(vector2di point,
  */
 bool PoissonDisc::InNeighborhood(vector2di centerPoint,
                                  int minimumDistance,
-                                 PointGrid2D pointGrid,
+                                 const PointGrid2D &pointGrid,
                                  float cellSize)
 {
     // Get the grid tile of the given point.
     vector2di centerTile = PointToGridTile(centerPoint, cellSize);
 
-    // Get all points on grid tiles around the center tile,
-    // including the point's own grid tile.
-    ListOfPoints pointsAroundCenterTile = GetPointsAroundTile(centerTile, pointGrid);
+    // We're checking a 5 by 5 grid around the center tile (including the center
+    // tile), so use half its row length as distance from the center tile to its edges.
+    int halfRowLength = 2;
 
-    // Loop over all points around the center tile and determine proximity.
-    for (vector2di otherPoint : pointsAroundCenterTile)
-    {
-        // Make sure there is a non default (-1, -1) point on the tile we sampled.
-        if (otherPoint != vector2di(-1, -1))
-        {
-            // Check the distance of the neighboring point from the centerpoint.
-            if (otherPoint.getDistanceFrom(centerPoint) < minimumDistance)
-            {
-                // Point is within minimum distance, so return true.
-                return true;
-            }
-        }
-    }
+    // Clamp the 5 by 5 area to the bounds of the point grid.
+    int minimumX = std::max(centerTile.X - halfRowLength, 0);
+    int minimumY = std::max(centerTile.Y - halfRowLength, 0);
+    int maximumX = std::min(centerTile.X + halfRowLength, static_cast<int>(pointGrid.dimensions.Width) - 1);
+    int maximumY = std::min(centerTile.Y + halfRowLength, static_cast<int>(pointGrid.dimensions.Height) - 1);
 
-    // No point found within minimum distance, so return false.
-    return false;
-}
+    // Compare squared distances, so no square roots are needed.
+    int minimumDistanceSquared = minimumDistance * minimumDistance;
 
-/**
- * @brief: Returns a list of points around the given tile, within the given
- * tile range.
- * 
- * @param centerTile: The tile to return a list of closely neighboring points for.
- * @param pointGrid: The point grid to check for points on.
- * @return ListOfPoints: The list of closely neighboring points.
- */
-ListOfPoints PoissonDisc::GetPointsAroundTile(vector2di centerTile, PointGrid2D pointGrid)
-{
-    // The list to fill with neighboring points.
-    ListOfPoints neighboringPoints;
-    
-    // The amount of tiles to check is 25 - 1, because we check a 5 by 5 grid around
-    // the center tile, minus the top left and bottom right corners, because they are
-    // always outside the minimum distance radius. This results in the loop starting
-    // at index 1, and needing to be run once fewer, hence 25 - 1.
-    int tilesToCheck = 24;
-    // We're checking a 5 by 5 grid, so row length is 5.
-    int rowLength = 5;
-    // Use half row length as distance from center tile to edges of area to check.
-    // Rounded down due to implicit int cast.
-    int halfRowLength = rowLength / 2;
-
-    // Loop through all tiles surrounding the given center tile (including the center tile).
-    // We start at 1, because the top left corner is excluded.
-    for (int tileNumber = 1; tileNumber < tilesToCheck; tileNumber++)
+    // Loop over all tiles around the center tile and determine proximity.
+    for (int y = minimumY; y <= maximumY; y++)
     {
-        // Skip the corner tiles, since points on them can never be within
-        // minimum distance. The first and last corners are never included
-        // in the loop, so we don't have to check for those.
-        if (tileNumber == 4 || tileNumber == 20)
+        for (int x = minimumX; x <= maximumX; x++)
         {
-            // Skip the tile and continue the loop.
-            continue;
-        }
+            // Skip the corner tiles, since points on them can never be within
+            // minimum distance.
+            if (std::abs(x - centerTile.X) == halfRowLength &&
+                std::abs(y - centerTile.Y) == halfRowLength)
+            {
+                continue;
+            }
 
-        // Calculate grid coordinates of current tile in loop.
-        vector2di tile = {centerTile.X - halfRowLength + tileNumber % rowLength,
-                          centerTile.Y - halfRowLength + tileNumber / rowLength};
+            const vector2di &otherPoint = pointGrid.At(vector2di(x, y));
 
-        // Make sure the tile is within the bounds of the point grid, otherwise skip.
-        if (!InsideRectangle(tile, vector2di(0), pointGrid.dimensions))
-        {
-            // Skip the tile and continue the loop.
-            continue;
+            // Make sure there is a non default (-1, -1) point on the tile we sampled.
+            if (otherPoint != vector2di(-1, -1))
+            {
+                // Check the distance of the neighboring point from the centerpoint.
+                if (otherPoint.getDistanceFromSQ(centerPoint) < minimumDistanceSquared)
+                {
+                    // Point is within minimum distance, so return true.
+                    return true;
+                }
+            }
         }
-
-        // Tile is within bounds of point grid, so grab the point on it.
-        neighboringPoints.push_back(pointGrid.grid[tile.X][tile.Y]);
     }
 
-    // Return the list of points found in the neighboring tiles.
-    return neighboringPoints;
+    // No point found within minimum distance, so return false.
+    return false;
 }
 
 /**
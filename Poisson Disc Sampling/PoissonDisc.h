@@ -33,6 +33,26 @@ typedef std::queue<vector2di> QueueOfPoints;
 class PoissonDisc
 {
 public:
+    /**
+     * @brief: The order in which generated points are processed.
+     */
+    enum SamplingAlgorithm
+    {
+        // Process points in the order they were generated, trying a fixed
+        // amount of new points around each of them once.
+        eQueue,
+        // Process a random active point each time, placing one new point
+        // around it per pass, and retire it once every attempt fails.
+        // Based on Robert Bridson's fast Poisson disk sampling:
+        // https://www.cs.ubc.ca/~rbridson/docs/bridson-siggraph07-poissondisk.pdf
+        eBridson
+    };
+
+    /**
+     * @brief: The default amount of new points tried around every processed point.
+     */
+    static const int DEFAULT_ATTEMPTS_PER_POINT = 30;
+
     /**
      * @brief: Defines a section of the poisson disc generation space.
      * Described by a shape, center position, and X & Y dimensions.
@@ -64,23 +84,42 @@ public:
      * @param maxNumberOfPoints: Max number of points to generate. If this parameter
      * is passed in, points will only be generated around the first point in the
      * existingPoints list.
+     * @param algorithm: The order in which points are processed.
+     * @param attemptsPerPoint: The amount of new points tried around every
+     * processed point. Higher values lead to points being grouped closer together.
      * @return ListOfPoints: The uniformly distributed list of points.
      */
     static ListOfPoints GeneratePoints(int minimumDistance,
                                        dimension2du mapDimensions,
                                        const std::vector<MapSection> &excludedSections = {},
                                        const ListOfPoints &existingPoints = {},
-                                       const int maxNumberOfPoints = MAX_INT);
+                                       const int maxNumberOfPoints = MAX_INT,
+                                       SamplingAlgorithm algorithm = eQueue,
+                                       int attemptsPerPoint = DEFAULT_ATTEMPTS_PER_POINT);
 
   private:
     /**
      * @brief: Shorthand class containing a grid of points, and the dimensions
-     * of that grid.
+     * of that grid. The tiles are stored in a single array, row by row, and
+     * tiles without a point hold (-1, -1).
      */
     struct PointGrid2D
     {
-        GridOfPoints grid;
+        ListOfPoints tiles;
         dimension2du dimensions;
+
+        /**
+         * @brief: Returns the point on the given tile, which must be on the grid.
+         */
+        vector2di &At(vector2di tile)
+        {
+            return tiles[tile.Y * dimensions.Width + tile.X];
+        }
+
+        const vector2di &At(vector2di tile) const
+        {
+            return tiles[tile.Y * dimensions.Width + tile.X];
+        }
     };
 
     static const int MAX_INT = 2147483647;
@@ -115,9 +154,27 @@ public:
      */
     static bool InsideRectangle(vector2di point, vector2di offset, dimension2du dimensions);
 
+    /**
+     * @brief: Places the given point on the point grid, if it is within the bounds
+     * of the map and not too close to any previously placed points.
+     * 
+     * @param point: The point to place.
+     * @param minimumDistance: The minimum distance between points.
+     * @param mapDimensions: The dimensions of the map the point must be on.
+     * @param pointGrid: The grid to place the point on.
+     * @param cellSize: The cell size of the point grid.
+     * @return bool: Whether the point was placed.
+     */
+    static bool TryPlacePoint(vector2di point,
+                              int minimumDistance,
+                              dimension2du mapDimensions,
+                              PointGrid2D &pointGrid,
+                              float cellSize);
+
     /**
      * @brief: Returns whether a point is already present on the point grid that is
      * less than the minimum distance between points away from the given point.
+     * Checks the tiles around the point directly on the grid, without copying anything.
      * 
      * @param point: The point to check for close neighbors for.
      * @param minimumDistance: The minimum distance between points.
@@ -128,19 +185,9 @@ public:
      */
     static bool InNeighborhood(vector2di point,
                                int minimumDistance,
-                               PointGrid2D pointGrid,
+                               const PointGrid2D &pointGrid,
                                float cellSize);
 
-    /**
-     * @brief: Returns a list of points around the given tile, within the given
-     * tile range.
-     * 
-     * @param centerTile: The tile to return a list of closely neighboring points for.
-     * @param pointGrid: The point grid to check for points on.
-     * @return ListOfPoints: The list of closely neighboring points.
-     */
-    static ListOfPoints GetPointsAroundTile(vector2di centerTile, PointGrid2D pointGrid);
-
     /**
      * @brief: Removes all points within a specified section from a given
      * list of points the section falls within.
@@ -8,12 +8,19 @@
 #include "IUpdatable.h"
 
 /**
- * @brief: The IUpdatable object adds itself to the GameWorld here.
+ * @brief: The IUpdatable object adds itself to the GameWorld here, unless
+ * told not to, in which case its owner has to call Update itself.
+ *
+ * @param addToGameWorld: Whether to add the object to the GameWorld update loop.
  */
-IUpdatable::IUpdatable()
+IUpdatable::IUpdatable(bool addToGameWorld)
+    : _inGameWorld(addToGameWorld)
 {
     // Add this object to the GameWorld update loop.
-    GameWorld::GetInstance()->Add(this);
+    if (_inGameWorld)
+    {
+        GameWorld::GetInstance()->Add(this);
+    }
 }
 
 /**
@@ -22,5 +29,8 @@ IUpdatable::IUpdatable()
 IUpdatable::~IUpdatable()
 {
     // Remove this object from the GameWorld update loop.
-    GameWorld::GetInstance()->Remove(this);
+    if (_inGameWorld)
+    {
+        GameWorld::GetInstance()->Remove(this);
+    }
 }
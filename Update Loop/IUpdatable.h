@@ -18,9 +18,12 @@ class IUpdatable
 {
 public:
     /**
-     * @brief: The IUpdatable object adds itself to the GameWorld here.
+     * @brief: The IUpdatable object adds itself to the GameWorld here, unless
+     * told not to, in which case its owner has to call Update itself.
+     *
+     * @param addToGameWorld: Whether to add the object to the GameWorld update loop.
      */
-    IUpdatable();
+    IUpdatable(bool addToGameWorld = true);
     /**
      * @brief: The IUpdatable object removes itself from the GameWorld here.
      */
@@ -33,4 +36,10 @@ public:
      * Remember to use Time::GetDeltaTime() for things that happen over time, like movement.
      */
     virtual void Update() = 0;
+
+private:
+    /**
+     * @brief: Whether the object was added to the GameWorld update loop.
+     */
+    bool _inGameWorld;
 };
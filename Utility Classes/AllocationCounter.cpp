@@ -0,0 +1,59 @@
+/**
+ * @brief: Contains the AllocationCounter class function implementations.
+ * @file AllocationCounter.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Define static variables first to prevent undefined ref errors.
+static std::atomic<long long> allocationCount(0);
+
+#if COUNT_ALLOCATIONS
+/**
+ * @brief: Replaces the global operator new to count every allocation.
+ */
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *memory = std::malloc(size > 0 ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief: Replaces the global operator delete to match the replaced operator new.
+ */
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+#endif
+
+/**
+ * @brief: Returns the number of heap allocations made since the program started.
+ * 
+ * @return long long: The number of allocations.
+ */
+long long AllocationCounter::GetAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief: Returns whether allocations are actually being counted.
+ * 
+ * @return bool: Whether the build defines COUNT_ALLOCATIONS.
+ */
+bool AllocationCounter::IsCounting()
+{
+    return COUNT_ALLOCATIONS;
+}
@@ -0,0 +1,38 @@
+/**
+ * @brief: Contains the AllocationCounter class header information.
+ * @file AllocationCounter.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+// Whether to count heap allocations. This replaces the global operator new and
+// delete, so only enable it in builds that are used for benchmarking, by
+// defining COUNT_ALLOCATIONS for the whole build (like -DCOUNT_ALLOCATIONS).
+#ifndef COUNT_ALLOCATIONS
+#define COUNT_ALLOCATIONS false
+#endif
+
+/**
+ * @brief: Counts heap allocations made through the global operator new, so
+ * benchmarks can report allocations per operation.
+ * Always returns 0 unless the build defines COUNT_ALLOCATIONS.
+ */
+class AllocationCounter
+{
+public:
+    /**
+     * @brief: Returns the number of heap allocations made since the program started.
+     * 
+     * @return long long: The number of allocations.
+     */
+    static long long GetAllocationCount();
+
+    /**
+     * @brief: Returns whether allocations are actually being counted.
+     * 
+     * @return bool: Whether the build defines COUNT_ALLOCATIONS.
+     */
+    static bool IsCounting();
+};
@@ -0,0 +1,79 @@
+/**
+ * @brief: Contains the BenchmarkHarness class function implementations.
+ * @file BenchmarkHarness.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "BenchmarkHarness.h"
+#include "AllocationCounter.h"
+#include "StringHelper.h"
+
+#include <iostream>
+
+/**
+ * @brief: Starts a timed section.
+ */
+void BenchmarkHarness::Start()
+{
+    _sectionStartAllocations = AllocationCounter::GetAllocationCount();
+    _sectionStart = std::chrono::high_resolution_clock::now();
+}
+
+/**
+ * @brief: Ends the timed section, adding its duration and allocations to the total.
+ */
+void BenchmarkHarness::Stop()
+{
+    // Read the clock first, so counting allocations isn't timed.
+    auto end = std::chrono::high_resolution_clock::now();
+    _totalTime += end - _sectionStart;
+    _totalAllocations += AllocationCounter::GetAllocationCount() - _sectionStartAllocations;
+}
+
+/**
+ * @brief: Returns the total of all timed sections, averaged over the given
+ * number of operations.
+ *
+ * @param operationCount: The number of operations the timed sections performed.
+ * @return Result: The cost of a single operation.
+ */
+BenchmarkHarness::Result BenchmarkHarness::GetResult(int operationCount) const
+{
+    Result result;
+    result.nanosecondsPerOperation =
+        std::chrono::duration<double, std::nano>(_totalTime).count() / operationCount;
+    result.allocationsPerOperation = static_cast<double>(_totalAllocations) / operationCount;
+    return result;
+}
+
+/**
+ * @brief: Prints the title of a benchmark run, noting when allocations aren't counted.
+ *
+ * @param title: The title to print.
+ */
+void BenchmarkHarness::PrintTitle(const std::string &title)
+{
+    std::cout << title;
+    if (!AllocationCounter::IsCounting())
+    {
+        std::cout << " (allocations not counted, build with COUNT_ALLOCATIONS defined)";
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief: Prints a benchmark result to the console.
+ *
+ * @param name: The name of the benchmark.
+ * @param result: The result to print.
+ * @param details: Printed after the result, for benchmark specific numbers.
+ */
+void BenchmarkHarness::PrintResult(const std::string &name, Result result, const std::string &details)
+{
+    std::cout << StringHelper::Format("  %-45s %14.1f ns/op %8.2f allocs/op",
+                                      name.c_str(),
+                                      result.nanosecondsPerOperation,
+                                      result.allocationsPerOperation)
+              << details << std::endl;
+}
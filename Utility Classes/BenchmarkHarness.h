@@ -0,0 +1,94 @@
+/**
+ * @brief: Contains the BenchmarkHarness class header information.
+ * @file BenchmarkHarness.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/**
+ * @brief: Measures the duration and heap allocations of benchmarked code, and
+ * prints the results to the console in a common format. Either measure a
+ * whole function at once with Measure, or add up timed sections with Start
+ * and Stop, leaving the setup between them out of the result.
+ * Allocations are only counted when the build defines COUNT_ALLOCATIONS.
+ */
+class BenchmarkHarness
+{
+public:
+    /**
+     * @brief: The average cost of a single benchmarked operation.
+     */
+    struct Result
+    {
+        double nanosecondsPerOperation = 0;
+        double allocationsPerOperation = 0;
+    };
+
+    /**
+     * @brief: Starts a timed section.
+     */
+    void Start();
+
+    /**
+     * @brief: Ends the timed section, adding its duration and allocations to the total.
+     */
+    void Stop();
+
+    /**
+     * @brief: Returns the total of all timed sections, averaged over the given
+     * number of operations.
+     *
+     * @param operationCount: The number of operations the timed sections performed.
+     * @return Result: The cost of a single operation.
+     */
+    Result GetResult(int operationCount) const;
+
+    /**
+     * @brief: Runs the given function as a single timed section, and returns its
+     * cost averaged over the given number of operations.
+     *
+     * @param operationCount: The number of operations the function performs.
+     * @param function: The function to measure.
+     * @return Result: The cost of a single operation.
+     */
+    template <typename Function>
+    static Result Measure(int operationCount, Function &&function)
+    {
+        BenchmarkHarness harness;
+        harness.Start();
+        function();
+        harness.Stop();
+        return harness.GetResult(operationCount);
+    }
+
+    /**
+     * @brief: Prints the title of a benchmark run, noting when allocations aren't counted.
+     *
+     * @param title: The title to print.
+     */
+    static void PrintTitle(const std::string &title);
+
+    /**
+     * @brief: Prints a benchmark result to the console.
+     *
+     * @param name: The name of the benchmark.
+     * @param result: The result to print.
+     * @param details: Printed after the result, for benchmark specific numbers.
+     */
+    static void PrintResult(const std::string &name, Result result,
+                            const std::string &details = std::string());
+
+private:
+    // The start of the current timed section.
+    std::chrono::high_resolution_clock::time_point _sectionStart;
+    long long _sectionStartAllocations = 0;
+
+    // The totals of all finished timed sections.
+    std::chrono::high_resolution_clock::duration _totalTime = std::chrono::high_resolution_clock::duration(0);
+    long long _totalAllocations = 0;
+};
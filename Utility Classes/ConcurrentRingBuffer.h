@@ -0,0 +1,157 @@
+/**
+ * @brief: Contains the ConcurrentRingBuffer class header information.
+ * @file ConcurrentRingBuffer.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief: A fixed-capacity queue that any number of threads can push to and pop
+ * from at the same time, without locks and without allocating.
+ * Each cell carries a sequence number that tells pushers and poppers whether it
+ * is free or filled, so threads only ever contend on a single atomic counter.
+ *
+ * Based on Dmitry Vyukov's bounded MPMC queue:
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * @tparam T The type of the values in the queue. Must be copyable.
+ * @tparam Capacity The maximum number of values in the queue. Must be a power of 2.
+ */
+template <typename T, std::size_t Capacity>
+class ConcurrentRingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "ConcurrentRingBuffer capacity must be a power of 2.");
+
+public:
+    ConcurrentRingBuffer()
+    {
+        // Every cell starts out free for the push at its own position.
+        for (std::size_t i = 0; i < Capacity; i++)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Threads may hold on to the address of the buffer, so never copy it.
+    ConcurrentRingBuffer(const ConcurrentRingBuffer &) = delete;
+    ConcurrentRingBuffer &operator=(const ConcurrentRingBuffer &) = delete;
+
+    /**
+     * @brief: Pushes a copy of the given value to the back of the queue.
+     * Safe to call from any thread.
+     *
+     * @param value: The value to push.
+     * @return bool: Whether the value was pushed. False if the queue was full.
+     */
+    bool TryPush(const T &value)
+    {
+        Cell *cell;
+        std::size_t position = _pushPosition.load(std::memory_order_relaxed);
+
+        // Claim the cell at the push position, unless another thread beats us to it.
+        for (;;)
+        {
+            cell = &_cells[position & (Capacity - 1)];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) -
+                                       static_cast<std::intptr_t>(position);
+
+            if (difference == 0)
+            {
+                // The cell is free, so try to move the push position past it.
+                if (_pushPosition.compare_exchange_weak(position, position + 1,
+                                                        std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The cell still holds a value from the previous lap, so we're full.
+                return false;
+            }
+            else
+            {
+                // Another thread claimed the cell, so retry at the new push position.
+                position = _pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Fill the cell, then publish it to poppers.
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief: Pops the value at the front of the queue.
+     * Safe to call from any thread.
+     *
+     * @param value: Set to the popped value.
+     * @return bool: Whether a value was popped. False if the queue was empty.
+     */
+    bool TryPop(T &value)
+    {
+        Cell *cell;
+        std::size_t position = _popPosition.load(std::memory_order_relaxed);
+
+        // Claim the cell at the pop position, unless another thread beats us to it.
+        for (;;)
+        {
+            cell = &_cells[position & (Capacity - 1)];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) -
+                                       static_cast<std::intptr_t>(position + 1);
+
+            if (difference == 0)
+            {
+                // The cell is filled, so try to move the pop position past it.
+                if (_popPosition.compare_exchange_weak(position, position + 1,
+                                                       std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The cell hasn't been filled yet, so we're empty.
+                return false;
+            }
+            else
+            {
+                // Another thread claimed the cell, so retry at the new pop position.
+                position = _popPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Read the cell, then free it for the push one lap further.
+        value = cell->value;
+        cell->sequence.store(position + Capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /**
+     * @brief: A single value in the queue, along with its sequence number.
+     */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    Cell _cells[Capacity];
+
+    /**
+     * @brief: The positions the next push and pop will claim, counting up forever.
+     */
+    std::atomic<std::size_t> _pushPosition{0};
+    std::atomic<std::size_t> _popPosition{0};
+};
@@ -0,0 +1,78 @@
+/**
+ * @brief: Contains the CursorWorldPosition class function implementations.
+ * @file CursorWorldPosition.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "CursorWorldPosition.h"
+
+/**
+ * @brief: Returns the world position under the mouse cursor.
+ * 
+ * @param cameraController: Used to raycast from the screen into the world.
+ * @return vector3df: The world position under the mouse cursor.
+ */
+vector3df CursorWorldPosition::GetWorldPosition(CameraController *cameraController)
+{
+    vector2di screenPosition = InputHandler::GetInstance()->GetMouseState().position;
+    ICameraSceneNode *camera = ApplicationInfo::device->getSceneManager()->getActiveCamera();
+    irr::core::recti viewport = ApplicationInfo::device->getVideoDriver()->getViewPort();
+
+    // Get the placement and projection of the active camera, if there is one.
+    vector3df cameraPosition = vector3df(0);
+    vector3df cameraTarget = vector3df(0);
+    float cameraFieldOfView = 0;
+    float cameraAspectRatio = 0;
+    if (camera)
+    {
+        cameraPosition = camera->getAbsolutePosition();
+        cameraTarget = camera->getTarget();
+        cameraFieldOfView = camera->getFOV();
+        cameraAspectRatio = camera->getAspectRatio();
+    }
+
+    // Only raycast again if the mouse, the camera or the viewport changed since
+    // the last raycast. A zoom or a window resize moves the ray without moving
+    // the camera.
+    if (!_valid ||
+        cameraController != _cameraController ||
+        screenPosition != _screenPosition ||
+        camera != _camera ||
+        cameraPosition != _cameraPosition ||
+        cameraTarget != _cameraTarget ||
+        cameraFieldOfView != _cameraFieldOfView ||
+        cameraAspectRatio != _cameraAspectRatio ||
+        viewport != _viewport)
+    {
+        _worldPosition = cameraController->GetWorldPositionFromScreenPosition(screenPosition);
+
+        _cameraController = cameraController;
+        _screenPosition = screenPosition;
+        _camera = camera;
+        _cameraPosition = cameraPosition;
+        _cameraTarget = cameraTarget;
+        _cameraFieldOfView = cameraFieldOfView;
+        _cameraAspectRatio = cameraAspectRatio;
+        _viewport = viewport;
+        _valid = true;
+
+        // Skip 0 on wrap around, so callers can use it as "never seen".
+        if (++_version == 0)
+        {
+            _version = 1;
+        }
+    }
+
+    return _worldPosition;
+}
+
+/**
+ * @brief: Returns a number that changes whenever the cached world position
+ * is recomputed. Compare it to a previously returned number to tell whether
+ * anything that depends on the cursor or camera needs updating.
+ */
+unsigned int CursorWorldPosition::GetVersion()
+{
+    return _version;
+}
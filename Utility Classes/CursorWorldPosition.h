@@ -0,0 +1,72 @@
+/**
+ * @brief: Contains the CursorWorldPosition class header information.
+ * @file CursorWorldPosition.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <irrlicht.h>
+
+#include "Singleton.h"
+#include "InputHandler.h"
+#include "ApplicationInfo.h"
+#include "CameraController.h"
+
+using irr::core::vector2di;
+using irr::core::vector3df;
+using irr::scene::ICameraSceneNode;
+
+/**
+ * @brief: Caches the world position under the mouse cursor, so every system
+ * that needs it shares a single screen-to-world raycast. The cached position
+ * is only recomputed when the mouse moved, the active camera moved or changed
+ * its projection, or the viewport was resized.
+ */
+class CursorWorldPosition : public Singleton<CursorWorldPosition>
+{
+public:
+    friend class Singleton;
+
+    /**
+     * @brief: Returns the world position under the mouse cursor.
+     * 
+     * @param cameraController: Used to raycast from the screen into the world.
+     * @return vector3df: The world position under the mouse cursor.
+     */
+    vector3df GetWorldPosition(CameraController *cameraController);
+
+    /**
+     * @brief: Returns a number that changes whenever the cached world position
+     * is recomputed. Compare it to a previously returned number to tell whether
+     * anything that depends on the cursor or camera needs updating.
+     */
+    unsigned int GetVersion();
+
+private:
+    // The camera controller the cached position was computed with.
+    CameraController *_cameraController = nullptr;
+
+    // The mouse position the cached position was computed for.
+    vector2di _screenPosition = vector2di(0);
+
+    // The active camera and its placement when the cached position was computed.
+    ICameraSceneNode *_camera = nullptr;
+    vector3df _cameraPosition = vector3df(0);
+    vector3df _cameraTarget = vector3df(0);
+
+    // The projection of the active camera and the viewport it rendered to.
+    float _cameraFieldOfView = 0;
+    float _cameraAspectRatio = 0;
+    irr::core::recti _viewport = irr::core::recti(0, 0, 0, 0);
+
+    // The cached world position under the cursor.
+    vector3df _worldPosition = vector3df(0);
+
+    // Whether the cached world position has been computed at all.
+    bool _valid = false;
+
+    // Incremented whenever the cached world position is recomputed.
+    unsigned int _version = 0;
+};
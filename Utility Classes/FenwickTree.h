@@ -0,0 +1,117 @@
+/**
+ * @brief: Contains the FenwickTree class header information.
+ * @file FenwickTree.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief: A fixed-size array of values that keeps the sums of its prefixes
+ * up to date, so changing a value and summing a prefix both take O(log n).
+ * Also known as a binary indexed tree.
+ *
+ * @tparam T The type of the values. Must support addition and subtraction.
+ */
+template <typename T>
+class FenwickTree
+{
+public:
+    /**
+     * @brief: Resizes the tree to the given number of values, all set to zero.
+     *
+     * @param size: The number of values.
+     */
+    void Reset(int size)
+    {
+        _sums.assign(size, T());
+    }
+
+    /**
+     * @brief: Returns the number of values in the tree.
+     */
+    int GetSize() const
+    {
+        return static_cast<int>(_sums.size());
+    }
+
+    /**
+     * @brief: Adds the given amount to the value at the given index.
+     *
+     * @param index: The index of the value.
+     * @param amount: The amount to add.
+     */
+    void Add(int index, T amount)
+    {
+        for (int node = index + 1; node <= GetSize(); node += node & -node)
+        {
+            _sums[node - 1] += amount;
+        }
+    }
+
+    /**
+     * @brief: Returns the sum of the values before the given index.
+     *
+     * @param end: The index to sum up to, excluding the value at it.
+     * @return T: The sum of the values at [0, end).
+     */
+    T GetSum(int end) const
+    {
+        T sum = T();
+        for (int node = end; node > 0; node &= node - 1)
+        {
+            sum += _sums[node - 1];
+        }
+
+        return sum;
+    }
+
+    /**
+     * @brief: Returns the sum of all values.
+     */
+    T GetTotal() const
+    {
+        return GetSum(GetSize());
+    }
+
+    /**
+     * @brief: Returns the first index where the sum of the values up to and
+     * including it exceeds the given sum. Only valid if no value is negative.
+     *
+     * @param sum: The sum to exceed.
+     * @return int: The index, or the size of the tree if no prefix exceeds the sum.
+     */
+    int FindIndexAfterSum(T sum) const
+    {
+        int index = 0;
+        int step = 1;
+        while (step * 2 <= GetSize())
+        {
+            step *= 2;
+        }
+
+        // Descend from the biggest power of two, skipping every node whose
+        // prefix doesn't exceed the sum yet.
+        for (; step > 0; step /= 2)
+        {
+            if (index + step <= GetSize() && !(sum < _sums[index + step - 1]))
+            {
+                index += step;
+                sum -= _sums[index - 1];
+            }
+        }
+
+        return index;
+    }
+
+private:
+    /**
+     * @brief: Partial sums. Node n, stored at n - 1, covers the values in
+     * (n - lowest set bit of n, n].
+     */
+    std::vector<T> _sums;
+};
@@ -0,0 +1,199 @@
+/**
+ * @brief: Contains the InplaceCallback class header information.
+ * @file InplaceCallback.h
+ * @author Gijs Sickenga
+ * @date 16-10-2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief: A void() callable that stores its target inside a fixed-size internal
+ * buffer instead of on the heap. Use this instead of std::function<void()> for
+ * callbacks that are created often, like build queue finish functions.
+ *
+ * Any lambda or functor that fits in CAPACITY bytes can be stored. Bigger targets
+ * are rejected at compile time, so a callback can never silently allocate.
+ */
+class InplaceCallback
+{
+public:
+    /**
+     * @brief: The maximum size in bytes of a stored callable.
+     * Enough for a lambda capturing a handful of pointers.
+     */
+    static const std::size_t CAPACITY = 4 * sizeof(void *);
+
+    /**
+     * @brief: Constructs an empty callback. Calling an empty callback does nothing.
+     */
+    InplaceCallback()
+    {
+    }
+
+    /**
+     * @brief: Constructs a callback that stores a copy of the given callable.
+     *
+     * @param function: The lambda or functor to store.
+     */
+    template <typename Function,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<Function>::type, InplaceCallback>::value>::type>
+    InplaceCallback(Function &&function)
+    {
+        typedef typename std::decay<Function>::type StoredType;
+
+        static_assert(sizeof(StoredType) <= CAPACITY,
+                      "Callable is too big to be stored in an InplaceCallback.");
+        static_assert(alignof(StoredType) <= alignof(Storage),
+                      "Callable alignment is too strict for an InplaceCallback.");
+
+        new (&_storage) StoredType(std::forward<Function>(function));
+        _invoke = &Invoke<StoredType>;
+        _manage = &Manage<StoredType>;
+    }
+
+    InplaceCallback(const InplaceCallback &other)
+    {
+        CopyFrom(other);
+    }
+
+    InplaceCallback(InplaceCallback &&other)
+    {
+        MoveFrom(other);
+    }
+
+    InplaceCallback &operator=(const InplaceCallback &other)
+    {
+        if (this != &other)
+        {
+            Reset();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceCallback &operator=(InplaceCallback &&other)
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    ~InplaceCallback()
+    {
+        Reset();
+    }
+
+    /**
+     * @brief: Calls the stored callable, if there is one.
+     */
+    void operator()()
+    {
+        if (_invoke)
+        {
+            _invoke(&_storage);
+        }
+    }
+
+    /**
+     * @brief: Returns whether a callable is stored.
+     */
+    explicit operator bool() const
+    {
+        return _invoke != nullptr;
+    }
+
+    /**
+     * @brief: Destroys the stored callable, leaving the callback empty.
+     */
+    void Reset()
+    {
+        if (_manage)
+        {
+            _manage(eDestroy, &_storage, nullptr);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+
+private:
+    // Operations the manage function can perform on the stored callable.
+    enum Operation
+    {
+        eCopy,
+        eMove,
+        eDestroy
+    };
+
+    typedef typename std::aligned_storage<CAPACITY, alignof(std::max_align_t)>::type Storage;
+
+    /**
+     * @brief: The buffer the callable lives in.
+     */
+    Storage _storage;
+
+    /**
+     * @brief: Calls the stored callable. Null when the callback is empty.
+     */
+    void (*_invoke)(void *storage) = nullptr;
+
+    /**
+     * @brief: Copies, moves or destroys the stored callable. Null when the callback is empty.
+     */
+    void (*_manage)(Operation operation, void *destination, void *source) = nullptr;
+
+    template <typename StoredType>
+    static void Invoke(void *storage)
+    {
+        (*static_cast<StoredType *>(storage))();
+    }
+
+    template <typename StoredType>
+    static void Manage(Operation operation, void *destination, void *source)
+    {
+        switch (operation)
+        {
+            case eCopy:
+                new (destination) StoredType(*static_cast<const StoredType *>(source));
+                break;
+
+            case eMove:
+                new (destination) StoredType(std::move(*static_cast<StoredType *>(source)));
+                break;
+
+            case eDestroy:
+                static_cast<StoredType *>(destination)->~StoredType();
+                break;
+        }
+    }
+
+    void CopyFrom(const InplaceCallback &other)
+    {
+        if (other._manage)
+        {
+            other._manage(eCopy, &_storage, const_cast<Storage *>(&other._storage));
+            _invoke = other._invoke;
+            _manage = other._manage;
+        }
+    }
+
+    void MoveFrom(InplaceCallback &other)
+    {
+        if (other._manage)
+        {
+            other._manage(eMove, &_storage, &other._storage);
+            _invoke = other._invoke;
+            _manage = other._manage;
+            other.Reset();
+        }
+    }
+};
@@ -0,0 +1,75 @@
+/**
+ * @brief: Contains the OccupancyBitmap class function implementations.
+ * @file OccupancyBitmap.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "OccupancyBitmap.h"
+
+/**
+ * @brief: Clears the bitmap and sizes it for a grid of the given dimensions.
+ *
+ * @param width: The number of nodes in the X direction.
+ * @param height: The number of nodes in the Y direction.
+ */
+void OccupancyBitmap::Initialize(int width, int height)
+{
+    _width = std::max(width, 0);
+    _height = std::max(height, 0);
+
+    // Round up, so the last partial word and region in each direction are included.
+    _wordColumns = (_width + WORD_BITS - 1) / WORD_BITS;
+    _regionRows = (_height + REGION_SIZE - 1) / REGION_SIZE;
+
+    _rowWords.assign(_wordColumns * _height, 0);
+    _blockWords.assign(_wordColumns * _regionRows, 0);
+}
+
+/**
+ * @brief: Marks the node at the given coordinate as occupied.
+ * The coordinate must lie within the bitmap.
+ */
+void OccupancyBitmap::Set(int x, int y)
+{
+    const int blocksPerRegion = REGION_SIZE / BLOCK_SIZE;
+
+    _rowWords[y * _wordColumns + x / WORD_BITS] |= std::uint64_t(1) << (x % WORD_BITS);
+
+    // The block is occupied now too.
+    int blockBit = (y / BLOCK_SIZE % blocksPerRegion) * blocksPerRegion +
+                   x / BLOCK_SIZE % blocksPerRegion;
+    _blockWords[(y / REGION_SIZE) * _wordColumns + x / REGION_SIZE] |= std::uint64_t(1) << blockBit;
+}
+
+/**
+ * @brief: Marks the node at the given coordinate as empty.
+ * The coordinate must lie within the bitmap.
+ */
+void OccupancyBitmap::Clear(int x, int y)
+{
+    const int blocksPerRegion = REGION_SIZE / BLOCK_SIZE;
+    int wordIndex = x / WORD_BITS;
+
+    _rowWords[y * _wordColumns + wordIndex] &= ~(std::uint64_t(1) << (x % WORD_BITS));
+
+    // The columns of the block of the node, as a mask on its row words.
+    int blockStartX = x / BLOCK_SIZE * BLOCK_SIZE;
+    std::uint64_t columnMask = GetColumnMask(blockStartX % WORD_BITS,
+                                             blockStartX % WORD_BITS + BLOCK_SIZE - 1);
+
+    // Leave the block bit alone if any other node in the block is still occupied.
+    int blockStartY = y / BLOCK_SIZE * BLOCK_SIZE;
+    int blockEndY = std::min(blockStartY + BLOCK_SIZE, _height);
+    for (int blockY = blockStartY; blockY < blockEndY; blockY++)
+    {
+        if ((_rowWords[blockY * _wordColumns + wordIndex] & columnMask) != 0)
+        {
+            return;
+        }
+    }
+
+    int blockBit = (y / BLOCK_SIZE % blocksPerRegion) * blocksPerRegion +
+                   x / BLOCK_SIZE % blocksPerRegion;
+    _blockWords[(y / REGION_SIZE) * _wordColumns + x / REGION_SIZE] &= ~(std::uint64_t(1) << blockBit);
+}
@@ -0,0 +1,231 @@
+/**
+ * @brief: Contains the OccupancyBitmap class header information.
+ * @file OccupancyBitmap.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief: One bit per grid node telling whether the node is occupied, plus a
+ * coarse summary level with one bit per BLOCK_SIZE x BLOCK_SIZE block telling
+ * whether anything in the block is occupied.
+ *
+ * Every row of nodes is stored as 64 bit words, and the summary bits of the 64
+ * blocks in a 64 x 64 node region share a single word. An area scan can thus
+ * skip an empty 64 x 64 region with one word test, skip empty 8 x 8 blocks by
+ * jumping straight to the next set summary bit, and jump between occupied
+ * nodes in a row the same way.
+ */
+class OccupancyBitmap
+{
+public:
+    /**
+     * @brief: The number of nodes in a row word.
+     */
+    static const int WORD_BITS = 64;
+
+    /**
+     * @brief: The width and height of a block, in nodes.
+     */
+    static const int BLOCK_SIZE = 8;
+
+    /**
+     * @brief: The width and height of the region summarized by one summary word, in nodes.
+     */
+    static const int REGION_SIZE = WORD_BITS;
+
+    /**
+     * @brief: Clears the bitmap and sizes it for a grid of the given dimensions.
+     *
+     * @param width: The number of nodes in the X direction.
+     * @param height: The number of nodes in the Y direction.
+     */
+    void Initialize(int width, int height);
+
+    /**
+     * @brief: Marks the node at the given coordinate as occupied.
+     * The coordinate must lie within the bitmap.
+     */
+    void Set(int x, int y);
+
+    /**
+     * @brief: Marks the node at the given coordinate as empty.
+     * The coordinate must lie within the bitmap.
+     */
+    void Clear(int x, int y);
+
+    /**
+     * @brief: Returns whether the node at the given coordinate is occupied.
+     * The coordinate must lie within the bitmap.
+     */
+    bool IsSet(int x, int y) const
+    {
+        return (_rowWords[y * _wordColumns + x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+    }
+
+    /**
+     * @brief: Calls the given visitor with the block X and Y of every block that
+     * overlaps the given area and has at least one occupied node.
+     * Empty regions and blocks are skipped without looking at their nodes.
+     * The area is clamped to the bitmap.
+     *
+     * @param minimumX: The X coordinate of the left column of the area.
+     * @param minimumY: The Y coordinate of the bottom row of the area.
+     * @param maximumX: The X coordinate of the right column of the area, inclusive.
+     * @param maximumY: The Y coordinate of the top row of the area, inclusive.
+     * @param visitor: Called with (int blockX, int blockY) for every occupied block.
+     */
+    template <typename Visitor>
+    void VisitOccupiedBlocksInArea(int minimumX, int minimumY, int maximumX, int maximumY,
+                                   Visitor &&visitor) const
+    {
+        if (!ClampArea(minimumX, minimumY, maximumX, maximumY))
+        {
+            return;
+        }
+
+        // The blocks the area overlaps.
+        int minimumBlockX = minimumX / BLOCK_SIZE;
+        int minimumBlockY = minimumY / BLOCK_SIZE;
+        int maximumBlockX = maximumX / BLOCK_SIZE;
+        int maximumBlockY = maximumY / BLOCK_SIZE;
+
+        const int blocksPerRegion = REGION_SIZE / BLOCK_SIZE;
+
+        for (int regionY = minimumY / REGION_SIZE; regionY <= maximumY / REGION_SIZE; regionY++)
+        {
+            for (int regionX = minimumX / REGION_SIZE; regionX <= maximumX / REGION_SIZE; regionX++)
+            {
+                std::uint64_t blockBits = _blockWords[regionY * _wordColumns + regionX];
+
+                // Skip the whole region if nothing in it is occupied.
+                if (blockBits == 0)
+                {
+                    continue;
+                }
+
+                // Mask out the blocks of the region that lie outside of the area.
+                blockBits &= GetBlockMask(minimumBlockX - regionX * blocksPerRegion,
+                                          minimumBlockY - regionY * blocksPerRegion,
+                                          maximumBlockX - regionX * blocksPerRegion,
+                                          maximumBlockY - regionY * blocksPerRegion);
+
+                // Jump from occupied block to occupied block.
+                while (blockBits != 0)
+                {
+                    int bit = CountTrailingZeros(blockBits);
+                    blockBits &= blockBits - 1;
+
+                    visitor(regionX * blocksPerRegion + bit % blocksPerRegion,
+                            regionY * blocksPerRegion + bit / blocksPerRegion);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief: Returns the index of the lowest set bit of the given word.
+     * The word must not be 0.
+     */
+    static int CountTrailingZeros(std::uint64_t word)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<int>(index);
+#elif defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        int index = 0;
+        while ((word & 1) == 0)
+        {
+            word >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+private:
+    /**
+     * @brief: Clamps the given area to the bitmap.
+     *
+     * @return bool: Whether any of the area is left.
+     */
+    bool ClampArea(int &minimumX, int &minimumY, int &maximumX, int &maximumY) const
+    {
+        minimumX = std::max(minimumX, 0);
+        minimumY = std::max(minimumY, 0);
+        maximumX = std::min(maximumX, _width - 1);
+        maximumY = std::min(maximumY, _height - 1);
+
+        return minimumX <= maximumX && minimumY <= maximumY;
+    }
+
+    /**
+     * @brief: Returns a word with the bits from the given first up to and
+     * including the given last bit set, both clamped to the word.
+     */
+    static std::uint64_t GetColumnMask(int first, int last)
+    {
+        first = std::max(first, 0);
+        last = std::min(last, WORD_BITS - 1);
+
+        std::uint64_t upToLast = (last == WORD_BITS - 1) ? ~std::uint64_t(0)
+                                                         : (std::uint64_t(1) << (last + 1)) - 1;
+        return upToLast & (~std::uint64_t(0) << first);
+    }
+
+    /**
+     * @brief: Returns a summary word with the bits of the given blocks of a
+     * region set, clamped to the region. Block coordinates are relative to the region.
+     */
+    static std::uint64_t GetBlockMask(int minimumBlockX, int minimumBlockY,
+                                      int maximumBlockX, int maximumBlockY)
+    {
+        const int blocksPerRegion = REGION_SIZE / BLOCK_SIZE;
+
+        minimumBlockX = std::max(minimumBlockX, 0);
+        minimumBlockY = std::max(minimumBlockY, 0);
+        maximumBlockX = std::min(maximumBlockX, blocksPerRegion - 1);
+        maximumBlockY = std::min(maximumBlockY, blocksPerRegion - 1);
+
+        // The bits of the columns in a single block row, repeated for every block row.
+        std::uint64_t rowMask = ((std::uint64_t(1) << (maximumBlockX + 1)) - 1) &
+                                ~((std::uint64_t(1) << minimumBlockX) - 1);
+
+        std::uint64_t mask = 0;
+        for (int blockY = minimumBlockY; blockY <= maximumBlockY; blockY++)
+        {
+            mask |= rowMask << (blockY * blocksPerRegion);
+        }
+        return mask;
+    }
+
+    // The number of nodes in the X and Y direction.
+    int _width = 0;
+    int _height = 0;
+
+    // The number of row words per row, which is also the number of regions per row.
+    int _wordColumns = 0;
+
+    // The number of regions in the Y direction.
+    int _regionRows = 0;
+
+    // The occupied bit of every node, row by row.
+    std::vector<std::uint64_t> _rowWords;
+
+    // The occupied bit of every block, one word per region, region row by region row.
+    // Bit (blockY % 8) * 8 + (blockX % 8) of a word holds the block at blockX, blockY.
+    std::vector<std::uint64_t> _blockWords;
+};
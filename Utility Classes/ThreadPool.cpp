@@ -0,0 +1,177 @@
+/**
+ * @brief: Contains the ThreadPool class function implementations.
+ * @file ThreadPool.cpp
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+// Whether the current thread is running iterations of a loop. A loop started
+// from within one can't wait for the workers, as they may be waiting on it.
+static thread_local bool runningIterations = false;
+
+/**
+ * @brief: Starts one worker thread per extra hardware thread.
+ */
+ThreadPool::ThreadPool()
+{
+    // The calling thread runs iterations too, so leave one hardware thread for it.
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    unsigned int workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        _workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+/**
+ * @brief: Stops and joins all worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread &worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief: Runs the given type-erased task for every index from 0 up to count.
+ */
+void ThreadPool::Run(int count, void (*invoke)(void *task, int index), void *task)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // Don't bother waking the workers for a single iteration, and never
+    // start a loop from within another one.
+    if (_workers.empty() || count == 1 || runningIterations)
+    {
+        RunSerially(count, invoke, task);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(_runMutex);
+
+    // The calling thread takes an iteration too, so a loop of a few iterations
+    // only needs a few workers. Waking the others would only cost them a context switch.
+    int workerCount = std::min(count - 1, static_cast<int>(_workers.size()));
+
+    // Publish the loop and wake up that many workers.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _count = count;
+        _invoke = invoke;
+        _task = task;
+        _nextIndex.store(0, std::memory_order_relaxed);
+        _openWorkerSlots = workerCount;
+        _busyWorkers = workerCount;
+        _loopNumber++;
+    }
+
+    if (workerCount == static_cast<int>(_workers.size()))
+    {
+        _workAvailable.notify_all();
+    }
+    else
+    {
+        // A worker that isn't waiting yet takes an open slot once it checks for
+        // work, so a notification that reaches no one loses nothing.
+        for (int i = 0; i < workerCount; i++)
+        {
+            _workAvailable.notify_one();
+        }
+    }
+
+    // Help out, then wait for the workers to finish the iterations they claimed
+    // and leave the loop, so none can touch the next loop's state.
+    RunIterations();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _workFinished.wait(lock, [this]
+    {
+        return _busyWorkers == 0;
+    });
+}
+
+/**
+ * @brief: Runs iterations of the current loop until none are left.
+ */
+void ThreadPool::RunIterations()
+{
+    runningIterations = true;
+
+    for (;;)
+    {
+        int index = _nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= _count)
+        {
+            break;
+        }
+
+        _invoke(_task, index);
+    }
+
+    runningIterations = false;
+}
+
+/**
+ * @brief: Calls the given type-erased task for every index from 0 up to
+ * count, one after another on the calling thread.
+ */
+void ThreadPool::RunSerially(int count, void (*invoke)(void *task, int index), void *task)
+{
+    for (int i = 0; i < count; i++)
+    {
+        invoke(task, i);
+    }
+}
+
+/**
+ * @brief: The loop of every worker thread.
+ */
+void ThreadPool::WorkerLoop()
+{
+    unsigned int lastLoopNumber = 0;
+
+    for (;;)
+    {
+        // Sleep until there's a loop this worker hasn't helped with yet, that
+        // still needs another worker.
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workAvailable.wait(lock, [&]
+            {
+                return _stopping || (_loopNumber != lastLoopNumber && _openWorkerSlots > 0);
+            });
+
+            if (_stopping)
+            {
+                return;
+            }
+            lastLoopNumber = _loopNumber;
+            _openWorkerSlots--;
+        }
+
+        RunIterations();
+
+        // Let the calling thread know once the last worker is done.
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busyWorkers--;
+        }
+        _workFinished.notify_one();
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @brief: Contains the ThreadPool class header information.
+ * @file ThreadPool.h
+ * @author Gijs Sickenga
+ * @date 17-10-2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Singleton.h"
+
+/**
+ * @brief: A fixed set of worker threads that run the iterations of a loop in
+ * parallel. The workers are started once and sleep between loops, so a loop
+ * only pays for waking them up, not for creating threads.
+ *
+ * The thread that starts a loop runs iterations too, and only returns once
+ * every iteration has finished, so iterations can safely refer to its locals.
+ */
+class ThreadPool : public Singleton<ThreadPool>
+{
+public:
+    friend class Singleton;
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief: Stops and joins all worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief: Returns the number of worker threads, not counting the calling thread.
+     * 0 on single core machines, in which case loops simply run on the calling thread.
+     */
+    int GetWorkerCount() const
+    {
+        return static_cast<int>(_workers.size());
+    }
+
+    /**
+     * @brief: Calls the given task once for every index from 0 up to count,
+     * spread over the worker threads and the calling thread, and waits for all
+     * of them to finish. Iterations may run in any order, so the task must only
+     * write to data owned by its own index.
+     * Only as many workers as there are iterations besides the calling thread's
+     * are woken up. Loops started from multiple threads at once run one after another.
+     * A loop started from within a task runs serially on the thread running
+     * that task, since the workers are all busy with the outer loop.
+     *
+     * @param count: The number of iterations.
+     * @param task: Called with an int index for every iteration.
+     */
+    template <typename Task>
+    void ParallelFor(int count, Task &task)
+    {
+        Run(count, &InvokeTask<Task>, &task);
+    }
+
+private:
+    /**
+     * @brief: Starts one worker thread per extra hardware thread.
+     */
+    ThreadPool();
+
+    /**
+     * @brief: Calls the task at the given address with the given index.
+     */
+    template <typename Task>
+    static void InvokeTask(void *task, int index)
+    {
+        (*static_cast<Task *>(task))(index);
+    }
+
+    /**
+     * @brief: Runs the given type-erased task for every index from 0 up to count.
+     */
+    void Run(int count, void (*invoke)(void *task, int index), void *task);
+
+    /**
+     * @brief: Runs iterations of the current loop until none are left.
+     */
+    void RunIterations();
+
+    /**
+     * @brief: Calls the given type-erased task for every index from 0 up to
+     * count, one after another on the calling thread.
+     */
+    static void RunSerially(int count, void (*invoke)(void *task, int index), void *task);
+
+    /**
+     * @brief: The loop of every worker thread.
+     */
+    void WorkerLoop();
+
+    std::vector<std::thread> _workers;
+
+    // Makes sure only one loop runs at a time.
+    std::mutex _runMutex;
+
+    // Guards the loop state below, and wakes up workers and the calling thread.
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workFinished;
+
+    // The current loop. Incremented per loop, so workers can tell a new loop apart.
+    unsigned int _loopNumber = 0;
+    int _count = 0;
+    void (*_invoke)(void *task, int index) = nullptr;
+    void *_task = nullptr;
+
+    // The next iteration to claim.
+    std::atomic<int> _nextIndex{0};
+
+    // The number of workers that may still join the current loop.
+    int _openWorkerSlots = 0;
+
+    // The number of workers that joined the current loop and haven't left it yet,
+    // plus the ones that have yet to join.
+    int _busyWorkers = 0;
+
+    bool _stopping = false;
+};